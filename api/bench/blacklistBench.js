@@ -0,0 +1,63 @@
+/**
+ * Compares per-check latency of the in-process Bloom addon with the TCP path.
+ *
+ * Usage (TCP server running on TCP_HOST:TCP_PORT, sharing BLOOM_DATA_FILE):
+ *   BLOOM_ADDON_PATH=../backend/build/bloom.node BLOOM_DATA_FILE=... \
+ *   BLOOM_FOLLOW=0 node bench/blacklistBench.js [iterations]
+ */
+const net = require('net');
+const { bloomAddon } = require('../src/utils/bloomAddon');
+
+const host = process.env.TCP_HOST || '127.0.0.1';
+const port = parseInt(process.env.TCP_PORT || '5555', 10);
+const iterations = parseInt(process.argv[2] || '2000', 10);
+
+// Same exchange as utils/tcpClient.js, with a configurable address
+function tcpGet(url) {
+  return new Promise((resolve, reject) => {
+    const client = net.createConnection(port, host, () => client.write(`GET ${url}\n`));
+    let response = '';
+    client.on('data', (data) => { response += data.toString(); });
+    client.on('end', () => resolve(response.includes('true true')));
+    client.on('error', reject);
+  });
+}
+
+function summarize(name, samples) {
+  samples.sort((a, b) => a - b);
+  const pick = (q) => samples[Math.min(samples.length - 1, Math.floor(q * samples.length))];
+  const mean = samples.reduce((a, b) => a + b, 0) / samples.length;
+  console.log(`${name.padEnd(6)} mean ${mean.toFixed(2)}us  p50 ${pick(0.5).toFixed(2)}us  ` +
+              `p99 ${pick(0.99).toFixed(2)}us  (${samples.length} checks)`);
+}
+
+async function main() {
+  const urls = Array.from({ length: 100 }, (_, i) => `www.site${i}.com`);
+
+  if (bloomAddon) {
+    const samples = [];
+    for (let i = 0; i < iterations; i++) {
+      const url = urls[i % urls.length];
+      const start = process.hrtime.bigint();
+      bloomAddon.check(url) && bloomAddon.doubleCheck(url);
+      samples.push(Number(process.hrtime.bigint() - start) / 1000);
+    }
+    summarize('addon', samples);
+  } else {
+    console.log('addon  skipped (BLOOM_ADDON_PATH not set)');
+  }
+
+  const samples = [];
+  for (let i = 0; i < iterations; i++) {
+    const url = urls[i % urls.length];
+    const start = process.hrtime.bigint();
+    await tcpGet(url);
+    samples.push(Number(process.hrtime.bigint() - start) / 1000);
+  }
+  summarize('tcp', samples);
+}
+
+main().catch((err) => {
+  console.error(err.message);
+  process.exit(1);
+});
@@ -72,20 +72,9 @@ class MailController {
     }
 
     const toUserId = recipient.id;
-    const urls = [...extractUrls(subject), ...extractUrls(body)];
-    let containsBlacklisted = false;
-
-    for (const url of urls) {
-      try {
-        const isBlacklisted = await blacklistService.checkUrl(url);
-        if (isBlacklisted) {
-          containsBlacklisted = true;
-          break; // we only need to know if *any* are blacklisted
-        }
-      } catch (err) {
-        return res.status(500).json({ error: 'Failed to check blacklist', details: err.message });
-      }
-    }
+    // One request checks every URL in the subject and body
+    const blacklisted = await blacklistService.findBlacklisted(`${subject}\n${body}`);
+    const containsBlacklisted = blacklisted.length > 0;
 
     // Create the mail first
     const mail = mailService.createMail({ fromUserId, toUserId, subject, body });
@@ -1,5 +1,8 @@
 // Import the reusable TCP command function from utils
 const { sendTcpCommand } = require('../utils/tcpClient');
+// In-process filter, when the native addon is configured (null otherwise)
+const { bloomAddon } = require('../utils/bloomAddon');
+const { extractUrls } = require('../utils/urlUtils');
 
 /**
  * Service to check whether a URL is blacklisted via the TCP Bloom filter server.
@@ -25,11 +28,17 @@ class BlacklistService {
   }
 
   /**
-   * Sends a "GET <url>" command to the TCP server and interprets the result.
+   * Sends a "GET <url>" command to the TCP server and interprets the result,
+   * or checks the in-process filter directly when the addon is enabled.
    * @param {string} url - The URL to check.
    * @returns {Promise<boolean>} - true if blacklisted, false otherwise.
    */
   async checkUrl(url) {
+    // Answer locally when the addon is loaded: same check + double-check as "GET"
+    if (bloomAddon) {
+      return bloomAddon.check(url) && bloomAddon.doubleCheck(url);
+    }
+
     try {
       // Send the GET command to the TCP server and wait for the response (e.g., "true true\n")
       const rawResponse = await sendTcpCommand(`GET ${url}`);
@@ -47,6 +56,35 @@ class BlacklistService {
       return false;
     }
   }
+
+  /**
+   * Finds the blacklisted URLs in a piece of text (e.g., a mail's subject and body).
+   * The TCP server extracts and checks them all in one "SCAN" request; with the
+   * addon, the URLs are extracted here and checked locally.
+   * @param {string} text - The text to scan.
+   * @returns {Promise<string[]>} - The blacklisted URLs found.
+   */
+  async findBlacklisted(text) {
+    if (bloomAddon) {
+      return extractUrls(text).filter(url => bloomAddon.check(url) && bloomAddon.doubleCheck(url));
+    }
+
+    try {
+      // "SCAN <bytes>" is followed by the text itself; the reply lists one
+      // blacklisted URL per line after a "urls <n> blacklisted <m>" line
+      const rawResponse = await sendTcpCommand(`SCAN ${Buffer.byteLength(text)}\n${text}`);
+      const lines = rawResponse.split('\n').map(line => line.trim());
+      if (!lines[0].startsWith('200')) {
+        throw new Error(`unexpected response: ${lines[0]}`);
+      }
+      return lines.slice(3).filter(line => line.length > 0);
+
+    } catch (err) {
+      // As for checkUrl: log and treat the text as clean
+      console.error('Blacklist scan failed:', err.message);
+      return [];
+    }
+  }
 }
 
 // Export an instance of the service so it can be used elsewhere in the app
@@ -0,0 +1,70 @@
+const fs = require('fs');
+
+// Size and hash depths of a save file: its first line holds one '0' or '1'
+// per bit, the second the depths. Reads no further than those two lines.
+function readSavedConfig(dataFile) {
+  const fd = fs.openSync(dataFile, 'r');
+  try {
+    const chunk = Buffer.alloc(1 << 16);
+    const parts = [];
+    let newlines = 0;
+    let bytesRead;
+    while (newlines < 2 && (bytesRead = fs.readSync(fd, chunk, 0, chunk.length, null)) > 0) {
+      const part = chunk.subarray(0, bytesRead).toString('latin1');
+      parts.push(part);
+      newlines += part.split('\n').length - 1;
+    }
+    const [bits = '', depths = ''] = parts.join('').split('\n');
+    return { size: /^[01]+$/.test(bits) ? bits.length : 0, depths: depths.trim() };
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+/**
+ * Optional in-process Bloom filter, backed by the native addon built from the
+ * C++ backend (backend target `bloom_node`). Used when the API runs next to the
+ * TCP server and can read its save file directly.
+ *
+ * Enabled by setting BLOOM_ADDON_PATH to the built bloom.node. Other settings:
+ *   BLOOM_DATA_FILE   - the TCP server's save file (default: data/filter_data.txt)
+ *   BLOOM_FILTER_SIZE - bit array size, same as the server's argv (default: read from the save file)
+ *   BLOOM_HASH_DEPTHS - space-separated hash depths (default: read from the save file)
+ *   BLOOM_FOLLOW      - reloads whenever the server saves a change; "0" turns it off
+ *
+ * Without a size or depths and without a readable save file, the addon isn't
+ * loaded: a guessed size would put every URL at the wrong bits.
+ *
+ * The addon is opened read-only: POST/DELETE still go through the TCP server,
+ * which owns the file.
+ */
+function loadAddon() {
+  const addonPath = process.env.BLOOM_ADDON_PATH;
+  if (!addonPath) return null;
+
+  try {
+    const { BloomFilter } = require(addonPath);
+    const dataFile = process.env.BLOOM_DATA_FILE || 'data/filter_data.txt';
+    const saved = process.env.BLOOM_FILTER_SIZE && process.env.BLOOM_HASH_DEPTHS ? null : readSavedConfig(dataFile);
+    const size = parseInt(process.env.BLOOM_FILTER_SIZE || saved.size, 10);
+    const depths = (process.env.BLOOM_HASH_DEPTHS || saved.depths).trim().split(/\s+/).map(Number);
+    if (!(size > 0) || !depths.every(depth => depth > 0)) {
+      throw new Error(`no filter size or hash depths in ${dataFile}; set BLOOM_FILTER_SIZE and BLOOM_HASH_DEPTHS`);
+    }
+
+    const bloom = new BloomFilter(dataFile, size, depths, { readOnly: true });
+
+    if (process.env.BLOOM_FOLLOW !== '0') {
+      // The server replaces the file atomically on every save, so polling its mtime is enough
+      fs.watchFile(dataFile, { interval: 200 }, (curr, prev) => {
+        if (curr.mtimeMs !== prev.mtimeMs) bloom.reload();
+      });
+    }
+    return bloom;
+  } catch (err) {
+    console.error(`Bloom addon unavailable, falling back to TCP: ${err.message}`);
+    return null;
+  }
+}
+
+module.exports = { bloomAddon: loadAddon() };
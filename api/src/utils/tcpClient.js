@@ -1,5 +1,9 @@
 const net = require('net');
 
+// When the API shares a host with the server, set TCP_SOCKET_PATH to the path
+// given to the server's --unix option to skip loopback TCP entirely.
+const socketPath = process.env.TCP_SOCKET_PATH;
+
 /**
  * Sends a command string to the TCP server (C++ backend).
  * @param {string} command - Command to send (e.g., "POST example.com")
@@ -10,9 +14,14 @@ function sendTcpCommand(command) {
     const client = new net.Socket();
     let response = '';
 
-    client.connect(5555, 'tcpserver', () => {
+    const onConnect = () => {
       client.write(command + '\n');
-    });
+    };
+    if (socketPath) {
+      client.connect(socketPath, onConnect);
+    } else {
+      client.connect(5555, 'tcpserver', onConnect);
+    }
 
     client.on('data', (data) => {
       response += data.toString();
@@ -1,11 +1,29 @@
+// Punctuation that ends a sentence rather than a URL, trimmed off the end of a path
+const TRAILING_PUNCTUATION = '.,;:!?\'")]}>';
+
+// Canonical form of a matched URL, the same as the server's SCAN reports:
+// trailing punctuation is trimmed off the path and a bare "/" path is dropped.
+// The host is left as it is, since the blacklist matches URLs exactly.
+function canonicalizeUrl(url) {
+  const schemeEnd = url.startsWith('https://') ? 8 : url.startsWith('http://') ? 7 : 0;
+  const hostEnd = url.indexOf('/', schemeEnd);
+  if (hostEnd === -1) return url;
+
+  let end = url.length;
+  while (end > hostEnd + 1 && TRAILING_PUNCTUATION.includes(url[end - 1])) end--;
+  if (end === hostEnd + 1) end = hostEnd; // A bare "/" path
+  return url.slice(0, end);
+}
+
 // Function to extract URLs from text
 function extractUrls(text) {
 // Match all URLs with or without http/https, optionally starting with www,
 // and containing a valid domain and optional path after the domain.
 const urlRegex = /((https?:\/\/)?(www\.)?([a-zA-Z0-9-]+\.)+[a-zA-Z]{2,}(\/\S*)?)/g;
 
-  // Find and return all matches, or an empty array if none found
-  return text.match(urlRegex) || [];
+  // Find all matches and return each canonical URL once, or an empty array if none found
+  const matches = text.match(urlRegex) || [];
+  return [...new Set(matches.map(canonicalizeUrl))];
 }
 
 // Export the function so other modules (e.g., MailController) can use it
@@ -0,0 +1,131 @@
+#include "Bloom/BloomFilter.h"      // Filter whose doubleCheck() is memoized
+#include "Bloom/FilterKernel.h"     // Bit indices for the save file
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>                 // For unlink()
+
+/**
+ * Cost of confirming a false positive with and without the false positive memo.
+ *
+ * Builds a small, crowded filter (written as a text save file, with the bits
+ * the server would have set) so that a good share of clean URLs match the bit
+ * array, draws a Zipf-distributed trace of clean URLs, keeps the GETs that
+ * check() lets through and times doubleCheck() on them: first with the memo
+ * off, then with memos of several sizes, each starting cold. Every run must
+ * find every URL clean.
+ *
+ * Usage: ./fp_memo_bench [BLACKLISTED_URLS] [DISTINCT_URLS] [GETS]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string blacklistedUrl(size_t i) {
+    return "https://www.site" + std::to_string(i % 991) + ".com/bad/" + std::to_string(i);
+}
+
+std::string cleanUrl(size_t rank) {
+    return "https://www.site" + std::to_string(rank % 997) + ".com/page/" + std::to_string(rank);
+}
+
+// Rank 0 is the most popular URL; P(rank) is proportional to 1 / (rank + 1)
+std::vector<std::string> zipfTrace(size_t gets, size_t distinct, unsigned seed) {
+    std::vector<double> cdf(distinct);
+    double total = 0;
+    for (size_t i = 0; i < distinct; ++i) cdf[i] = total += 1.0 / double(i + 1);
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0, total);
+    std::vector<std::string> trace;
+    trace.reserve(gets);
+    for (size_t i = 0; i < gets; ++i) {
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+        trace.push_back(cleanUrl(std::min(rank, distinct - 1)));
+    }
+    return trace;
+}
+
+// Best of three passes, as ns per URL; counts the URLs reported blacklisted
+double timeDoubleCheck(BloomFilter& filter, size_t memoEntries, const std::vector<std::string>& urls,
+                       size_t& blacklisted) {
+    double best = 0;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        filter.setFalsePositiveMemo(memoEntries);
+        blacklisted = 0;
+        auto start = Clock::now();
+        for (const std::string& url : urls) blacklisted += filter.doubleCheck(url);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / urls.size();
+        if (repeat == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t blacklisted = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t distinct = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    size_t gets = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2000000;
+    if (blacklisted == 0 || distinct == 0 || gets == 0) {
+        std::fprintf(stderr, "Usage: %s [BLACKLISTED_URLS] [DISTINCT_URLS] [GETS]\n", argv[0]);
+        return 1;
+    }
+    const std::string saveFile = "fp_memo_bench.txt";
+    const size_t bits = size_t(1) << 22;
+    std::vector<int> depths{1, 2, 3};
+
+    {
+        FilterKernel::Kernel kernel = FilterKernel::select(depths, bits, FilterKernel::layoutPreserving(bits));
+        std::string line(bits, '0');
+        std::vector<uint64_t> indices(depths.size());
+        std::ofstream out(saveFile);
+        std::string urls;
+        for (size_t i = 0; i < blacklisted; ++i) {
+            std::string url = blacklistedUrl(i);
+            kernel.indices(kernel, url, indices.data());
+            for (uint64_t index : indices) line[index] = '1';
+            urls += url + "\n";
+        }
+        out << line << "\n1 2 3 \n" << urls;
+    }
+
+    BloomFilter filter(bits, depths, saveFile);
+    std::vector<std::string> trace = zipfTrace(gets, distinct, 42);
+
+    std::vector<std::string> positives;
+    for (const std::string& url : trace) {
+        if (filter.check(url)) positives.push_back(url);
+    }
+    if (positives.empty()) {
+        std::fprintf(stderr, "No false positives; use more blacklisted URLs\n");
+        unlink(saveFile.c_str());
+        return 1;
+    }
+    std::printf("%zu blacklisted URLs, %zu distinct clean URLs, %zu GETs, %.1f%% false positives\n",
+                blacklisted, distinct, gets, 100.0 * positives.size() / gets);
+
+    size_t wrong;
+    double plain = timeDoubleCheck(filter, 0, positives, wrong);
+    std::printf("  %-16s %8.1f ns/false positive\n", "no memo", plain);
+
+    int status = wrong ? 1 : 0;
+    for (size_t entries : {size_t(4096), size_t(65536), size_t(1) << 20}) {
+        double memoized = timeDoubleCheck(filter, entries, positives, wrong);
+        const FalsePositiveMemo& memo = *filter.falsePositiveMemo();
+        const FalsePositiveMemo::Stats& stats = memo.stats();
+        std::printf("  memo %-11zu %8.1f ns/false positive  hit rate %5.1f%%  evictions %llu%s\n", memo.capacity(),
+                    memoized, 100.0 * stats.hits / (stats.hits + stats.inserts), (unsigned long long)stats.evictions,
+                    wrong ? "  WRONG VERDICTS" : "");
+        if (wrong) status = 1;
+    }
+
+    unlink(saveFile.c_str());
+    return status;
+}
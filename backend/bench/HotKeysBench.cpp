@@ -0,0 +1,123 @@
+#include "Analytics/HotKeys.h"      // Heavy-hitter counters under test
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Cost and accuracy of the heavy-hitter counters behind TOPK.
+ *
+ * Generates GETs over a Zipf-distributed URL population (a few viral links, a
+ * long tail of one-off URLs), then times HotKeys::recordGet() with recording
+ * off and on, on one thread and on several. Finally compares TOPK urls with
+ * the exact counts: how many of the true top 10 it found, and the largest
+ * relative over-estimate among them.
+ *
+ * Usage: ./hot_keys_bench [GETS_PER_THREAD] [THREADS] [DISTINCT_URLS]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// URL ranks drawn from Zipf(1.0) over `distinct` URLs, by inverting the CDF
+std::vector<std::string> zipfTrace(size_t gets, size_t distinct, unsigned seed) {
+    std::vector<double> cdf(distinct);
+    double total = 0;
+    for (size_t i = 0; i < distinct; ++i) cdf[i] = total += 1.0 / double(i + 1);
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0, total);
+    std::vector<std::string> trace;
+    trace.reserve(gets);
+    for (size_t i = 0; i < gets; ++i) {
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+        trace.push_back("https://www.site" + std::to_string(rank % 997) + ".com/page/" + std::to_string(rank));
+    }
+    return trace;
+}
+
+// Keeps the optimizer from dropping the baseline loop
+volatile size_t sink;
+
+// Reading every URL once, as the server has just done when parsing the request.
+// The trace is far larger than the caches, so this is mostly memory latency.
+double touchCost(const std::vector<std::string>& trace) {
+    auto start = Clock::now();
+    size_t sum = 0;
+    for (const auto& url : trace) sum += std::hash<std::string>()(url);
+    sink = sum;
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / trace.size();
+}
+
+double recordCost(const std::vector<std::string>& trace) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < trace.size(); ++i) HotKeys::instance().recordGet(trace[i], (i & 63) == 0);
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / trace.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t gets = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    size_t distinct = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000000;
+    if (gets == 0 || threads <= 0 || distinct == 0) {
+        std::fprintf(stderr, "Usage: %s [GETS_PER_THREAD] [THREADS] [DISTINCT_URLS]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::vector<std::string>> traces;
+    for (int t = 0; t < threads; ++t) traces.push_back(zipfTrace(gets, distinct, 42 + t));
+
+    double touch = touchCost(traces[0]);
+    HotKeys::instance().setEnabled(false);
+    double off = recordCost(traces[0]);
+    HotKeys::instance().setEnabled(true);
+    double on = recordCost(traces[0]);
+
+    // Every thread replays its own trace; the first trace is now counted twice
+    std::vector<double> costs(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&costs, &traces, t]() { costs[t] = recordCost(traces[t]); });
+    }
+    for (auto& worker : workers) worker.join();
+    double parallel = 0;
+    for (double cost : costs) parallel += cost / threads;
+
+    std::unordered_map<std::string, uint64_t> exact;
+    for (int t = 0; t < threads; ++t) {
+        for (const auto& url : traces[t]) exact[url] += t == 0 ? 2 : 1;
+    }
+    std::vector<std::pair<std::string, uint64_t>> truth(exact.begin(), exact.end());
+    std::partial_sort(truth.begin(), truth.begin() + std::min<size_t>(10, truth.size()), truth.end(),
+                      [](const auto& a, const auto& b) { return a.second > b.second; });
+    truth.resize(std::min<size_t>(10, truth.size()));
+
+    auto reported = HotKeys::instance().top(HotKeys::URLS, 10);
+    size_t found = 0;
+    double worstError = 0;
+    for (const auto& key : truth) {
+        for (const auto& entry : reported) {
+            if (entry.first != key.first) continue;
+            ++found;
+            worstError = std::max(worstError, double(entry.second - key.second) / key.second);
+        }
+    }
+
+    std::printf("%zu GETs per thread over %zu distinct URLs (Zipf 1.0)\n", gets, distinct);
+    std::printf("ns per recordGet (URL, domain, every 64th a false positive)\n");
+    std::printf("  reading the URL only   %6.1f\n", touch);
+    std::printf("  recording off          %6.1f\n", off);
+    std::printf("  recording on, 1 thread %6.1f\n", on);
+    std::printf("  recording on, %d threads %5.1f\n", threads, parallel);
+    std::printf("TOPK urls 10: %zu of the true top 10, worst over-estimate %.2f%%\n", found, worstError * 100);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "Bloom/FilterKernel.h"     // Specialized probe kernels
+#include "Bloom/HashFunctions.h"    // make_hash, the reference the kernels must match
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Micro-benchmark for the filter's probe kernels.
+ *
+ * Checks that the kernels probe exactly the bits the original code did
+ * (make_hash(url, depth) % bitCount), then reports:
+ *  - the cost of one index reduction: '%' versus the kernel reducers;
+ *  - the cost of one membership check and per probe, for the original loop
+ *    versus the specialized kernels, at several hash counts.
+ *
+ * Usage: ./kernel_bench [URLS] [BITS]
+ *   URLS is the number of distinct URLs probed per round (default 20000),
+ *   BITS the filter size (default 1000003, a prime, so MODULO is exercised).
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the optimizer from dropping benchmark loops
+volatile uint64_t sink;
+
+double nsSince(Clock::time_point start, size_t operations) {
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return ns / operations;
+}
+
+// The filter's check before kernels: runtime loop, one full make_hash chain and a division per probe
+bool originalCheck(const std::vector<uint64_t>& words, const std::vector<int>& depths,
+                   uint64_t bitCount, const std::string& url) {
+    for (int depth : depths) {
+        size_t index = make_hash(url, depth) % bitCount;
+        if (!(words[index / 64] & (uint64_t(1) << (index % 64)))) return false;
+    }
+    return true;
+}
+
+// Kernel indices must equal make_hash % bitCount for every depth, in sorted order
+bool verify(const std::vector<std::string>& urls, const std::vector<int>& depths, uint64_t bitCount,
+            FilterKernel::Reduction reduction) {
+    FilterKernel::Kernel kernel = FilterKernel::select(depths, bitCount, reduction);
+    std::vector<uint64_t> got(depths.size());
+    for (const auto& url : urls) {
+        kernel.indices(kernel, url, got.data());
+        for (size_t i = 0; i < kernel.depths.size(); ++i) {
+            if (got[i] != make_hash(url, kernel.depths[i]) % bitCount) return false;
+        }
+    }
+    return true;
+}
+
+template <class Reduce>
+double reduceCost(const std::vector<uint64_t>& hashes, const Reduce& reduce) {
+    uint64_t sum = 0;
+    auto start = Clock::now();
+    for (int round = 0; round < 20; ++round) {
+        for (uint64_t h : hashes) sum += reduce(h);
+    }
+    sink = sum;
+    return nsSince(start, hashes.size() * 20);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t urlCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    uint64_t bitCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000003;
+    if (urlCount == 0 || bitCount == 0) {
+        std::fprintf(stderr, "Usage: %s [URLS] [BITS]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    std::vector<std::string> urls;
+    for (size_t i = 0; i < urlCount; ++i) {
+        urls.push_back("www.site" + std::to_string(rng() % 100000000) + ".com/path/" + std::to_string(i));
+    }
+
+    // Correctness: the layout-preserving reductions must match the original bit positions
+    std::vector<int> mixed = {3, 1, 7, 2, 2};
+    uint64_t powerOfTwo = uint64_t(1) << 20;
+    bool ok = verify(urls, mixed, bitCount, FilterKernel::Reduction::MODULO)
+           && verify(urls, mixed, powerOfTwo, FilterKernel::Reduction::MODULO)
+           && verify(urls, mixed, powerOfTwo, FilterKernel::Reduction::MASK)
+           && verify(urls, std::vector<int>(20, 1), bitCount, FilterKernel::Reduction::MODULO);
+    std::printf("kernel indices match make_hash %% bits: %s\n\n", ok ? "yes" : "NO");
+    if (!ok) return 1;
+
+    // Index reduction alone
+    std::vector<uint64_t> hashes(1 << 16);
+    for (auto& h : hashes) h = rng();
+    FilterKernel::Kernel plain = FilterKernel::select({1}, bitCount, FilterKernel::Reduction::MODULO);
+    struct Divide {
+        uint64_t n;
+        uint64_t operator()(uint64_t h) const { return h % n; }
+    };
+    std::printf("index reduction, ns per hash (bits=%llu)\n", static_cast<unsigned long long>(bitCount));
+    std::printf("  %%          %6.2f\n", reduceCost(hashes, Divide{bitCount}));
+    std::printf("  fastmod    %6.2f\n", reduceCost(hashes, plain.modulo));
+    std::printf("  mask       %6.2f  (power-of-two sizes only)\n", reduceCost(hashes, plain.mask));
+    std::printf("  fast-range %6.2f  (different bit layout)\n\n", reduceCost(hashes, plain.fastRange));
+
+    // Whole checks against a filter holding every URL, so all k probes run
+    std::printf("check of a present URL, depths 1..k: ns per check / ns per probe\n");
+    std::printf("   k   original          kernel(mod)       kernel(fast-range)\n");
+    for (int k : {1, 2, 3, 4, 8, 16}) {
+        std::vector<int> depths;
+        for (int d = 1; d <= k; ++d) depths.push_back(d);
+
+        std::vector<uint64_t> words((bitCount + 63) / 64, 0);
+        std::vector<uint64_t> fastWords((bitCount + 63) / 64, 0);
+        FilterKernel::Kernel modKernel = FilterKernel::select(depths, bitCount, FilterKernel::Reduction::MODULO);
+        FilterKernel::Kernel fastKernel = FilterKernel::select(depths, bitCount, FilterKernel::Reduction::FAST_RANGE);
+        std::vector<uint64_t> index(k);
+        for (const auto& url : urls) {
+            modKernel.indices(modKernel, url, index.data());
+            for (uint64_t i : index) words[i / 64] |= uint64_t(1) << (i % 64);
+            fastKernel.indices(fastKernel, url, index.data());
+            for (uint64_t i : index) fastWords[i / 64] |= uint64_t(1) << (i % 64);
+        }
+
+        uint64_t hits = 0;
+        auto start = Clock::now();
+        for (const auto& url : urls) hits += originalCheck(words, depths, bitCount, url);
+        double original = nsSince(start, urls.size());
+
+        start = Clock::now();
+        for (const auto& url : urls) hits += modKernel.contains(modKernel, words.data(), url);
+        double modulo = nsSince(start, urls.size());
+
+        start = Clock::now();
+        for (const auto& url : urls) hits += fastKernel.contains(fastKernel, fastWords.data(), url);
+        double fast = nsSince(start, urls.size());
+        sink = hits;
+
+        std::printf("  %2d   %7.0f / %5.0f   %7.0f / %5.0f   %7.0f / %5.0f\n",
+                    k, original, original / k, modulo, modulo / k, fast, fast / k);
+    }
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include "Bloom/PageArena.h"        // Huge page and NUMA placement under test
+
+#include <linux/perf_event.h>       // For perf_event_attr and the dTLB counter encoding
+#include <sched.h>                  // For sched_setaffinity()
+#include <sys/ioctl.h>              // For the perf enable/disable ioctls
+#include <sys/syscall.h>            // For SYS_perf_event_open
+#include <unistd.h>                 // For syscall(), read(), close()
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Probe latency of a large bit array under each memory placement.
+ *
+ * For every huge page policy (off, thp, hugetlb), maps a bit array through
+ * PageArena, fills it, then runs a chain of dependent random probes, so each
+ * probe waits for the previous load like a filter check does. Reports
+ * ns per probe and dTLB load misses per probe (from perf_event_open; "n/a"
+ * when perf counters are not permitted), plus how much of the array ended up
+ * on huge pages.
+ *
+ * On hosts with more than one NUMA node, also pins the thread to node 0 and
+ * probes a copy bound to each node, which is the local versus remote cost that
+ * --numa-replicate avoids.
+ *
+ * Usage: ./memory_bench [MIB] [PROBES]
+ *   MIB is the bit array size in MiB (default 512), PROBES the probes per run
+ *   (default 20000000).
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the optimizer from dropping the probe loop
+volatile uint64_t sink;
+
+// dTLB read misses for this thread, or -1 if the counter can't be opened
+class TlbCounter {
+public:
+    TlbCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~TlbCounter() {
+        if (fd >= 0) close(fd);
+    }
+
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long count = 0;
+        if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+        return count;
+    }
+
+private:
+    int fd;
+};
+
+// AnonHugePages of the whole process, in KiB
+long anonHugeKb() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string key;
+    long value;
+    while (in >> key) {
+        if (key == "AnonHugePages:" && in >> value) return value;
+        in.ignore(1 << 10, '\n');
+    }
+    return 0;
+}
+
+// Pins the calling thread to the CPUs of a NUMA node, as listed in sysfs ("0-3,8-11")
+bool pinToNode(int node) {
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (!(in >> list)) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        std::string range = list.substr(pos, end - pos);
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) CPU_SET(cpu, &set);
+        pos = end + 1;
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Dependent random probes: each bit index is derived from the previous result
+void run(const char* label, PageArena& arena, size_t words, size_t probes) {
+    long hugeBefore = anonHugeKb();
+    uint64_t* bits = static_cast<uint64_t*>(arena.allocate(words * sizeof(uint64_t)));
+    for (size_t i = 0; i < words; ++i) bits[i] = 0x9E3779B97F4A7C15ULL * (i + 1);
+    long hugeKb = anonHugeKb() - hugeBefore;
+
+    uint64_t bitCount = words * 64;
+    uint64_t state = 0x12345678;
+    uint64_t found = 0;
+
+    TlbCounter tlb;
+    tlb.start();
+    auto start = Clock::now();
+    for (size_t i = 0; i < probes; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL + found;
+        uint64_t index = static_cast<uint64_t>((__uint128_t(state) * bitCount) >> 64);
+        found = (bits[index / 64] >> (index % 64)) & 1;
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / probes;
+    long long misses = tlb.stop();
+    sink = state;
+
+    char tlbText[32];
+    if (misses < 0) std::snprintf(tlbText, sizeof(tlbText), "n/a");
+    else std::snprintf(tlbText, sizeof(tlbText), "%.3f", double(misses) / probes);
+
+    std::printf("  %-22s %7.1f ns/probe   dTLB misses/probe %-7s huge pages %5ld MiB%s\n",
+                label, ns, tlbText, hugeKb / 1024, arena.fellBack() ? "  (no hugetlb pages, used thp)" : "");
+
+    arena.deallocate(bits, words * sizeof(uint64_t));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+    size_t probes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000000;
+    if (mib == 0 || probes == 0) {
+        std::fprintf(stderr, "Usage: %s [MIB] [PROBES]\n", argv[0]);
+        return 1;
+    }
+    size_t words = mib * (1 << 20) / sizeof(uint64_t);
+
+    std::printf("%zu MiB bit array, %zu dependent probes\n", mib, probes);
+    const struct {
+        const char* name;
+        HugePages policy;
+    } policies[] = {
+        {"huge-pages=off", HugePages::OFF},
+        {"huge-pages=thp", HugePages::THP},
+        {"huge-pages=hugetlb", HugePages::HUGETLB},
+    };
+    for (const auto& policy : policies) {
+        PageArena arena(policy.policy);
+        run(policy.name, arena, words, probes);
+    }
+
+    int nodes = PageArena::nodeCount();
+    if (nodes < 2) {
+        std::printf("\n1 NUMA node: replication has no remote copies to avoid\n");
+        return 0;
+    }
+
+    std::printf("\nthread on node 0, array bound to each node (thp)\n");
+    if (!pinToNode(0)) std::printf("  (could not pin to node 0)\n");
+    for (int node = 0; node < nodes; ++node) {
+        PageArena arena(HugePages::THP, node);
+        std::string label = "memory on node " + std::to_string(node) + (node == 0 ? " (local)" : " (remote)");
+        run(label.c_str(), arena, words, probes);
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include "Trace/Capture.h"          // Capture file reader
+#include "Server/BinaryProtocol.h"  // Frame headers, to read binary responses
+
+#include <arpa/inet.h>              // For inet_pton()
+#include <netinet/in.h>             // For sockaddr_in
+#include <sys/socket.h>             // For socket(), connect(), send(), recv()
+#include <sys/un.h>                 // For sockaddr_un
+#include <unistd.h>                 // For close()
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Replays a traffic capture (server --capture=PATH) against a running server.
+ *
+ * Requests are sent in capture order by CONNECTIONS workers, each text
+ * command on a new connection (as the API does) and binary frames on one
+ * persistent binary connection per worker. SPEED "1" keeps the captured
+ * timing, "2" plays it twice as fast, and "max" sends as fast as the server
+ * answers. With timing kept, latency is measured from when the request was due,
+ * so a slow server can't hide its queueing delay by slowing the replay.
+ *
+ * Every response is compared with the recorded one, except for commands
+ * whose answers change between runs (STATS, TRACE, TOPK, SNAPSHOT, DIFF, MEMORY).
+ * Start the server from the filter file saved when the capture began, so
+ * GET answers match; with several connections, requests that race (a GET
+ * right after the POST of the same URL) may still be reported.
+ *
+ * Usage: ./replay <CAPTURE> <PORT|unix:PATH> [CONNECTIONS] [SPEED] [HOST]
+ * Exits with 1 if any response differed or failed.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Target {
+    int family;
+    sockaddr_storage addr;
+    socklen_t addrLen;
+};
+
+// Parses "<port>" or "unix:<path>"
+bool parseTarget(const std::string& spec, const char* host, Target& target) {
+    std::memset(&target, 0, sizeof(target));
+    if (spec.compare(0, 5, "unix:") == 0) {
+        std::string path = spec.substr(5);
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&target.addr);
+        if (path.empty() || path.size() >= sizeof(un->sun_path)) return false;
+        un->sun_family = AF_UNIX;
+        std::strncpy(un->sun_path, path.c_str(), sizeof(un->sun_path) - 1);
+        target.family = AF_UNIX;
+        target.addrLen = sizeof(sockaddr_un);
+        return true;
+    }
+
+    sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&target.addr);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(static_cast<uint16_t>(std::atoi(spec.c_str())));
+    target.family = AF_INET;
+    target.addrLen = sizeof(sockaddr_in);
+    return inet_pton(AF_INET, host, &in->sin_addr) == 1;
+}
+
+int connectTarget(const Target& target) {
+    int fd = socket(target.family, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&target.addr), target.addrLen) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// One text command on its own connection; the server half-closes after answering
+bool runText(const Target& target, const std::string& line, std::string& response) {
+    int fd = connectTarget(target);
+    if (fd < 0) return false;
+
+    bool ok = sendAll(fd, line + "\n");
+    char buffer[4096];
+    ssize_t n;
+    while (ok && (n = recv(fd, buffer, sizeof(buffer), 0)) > 0) response.append(buffer, n);
+    close(fd);
+    return ok && !response.empty();
+}
+
+// One frame on the worker's binary connection, and the frame that answers it
+bool runFrame(int fd, const std::string& frame, std::string& response) {
+    if (fd < 0 || !sendAll(fd, frame)) return false;
+
+    char buffer[4096];
+    BinaryProtocol::Header header;
+    while (true) {
+        if (response.size() >= BinaryProtocol::HEADER_SIZE) {
+            if (!BinaryProtocol::decodeHeader(response.data(), header)) return false;
+            if (response.size() >= BinaryProtocol::HEADER_SIZE + header.length) return true;
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return false;
+        response.append(buffer, n);
+    }
+}
+
+// Text commands whose answers legitimately differ from run to run
+bool verifiable(const Capture::Record& record) {
+    if (record.kind != Capture::TEXT) return true;
+    static const char* const volatileCommands[] = {"STATS", "TRACE", "TOPK", "SNAPSHOT", "DIFF", "MEMORY"};
+    std::string keyword = record.request.substr(0, record.request.find(' '));
+    for (const char* command : volatileCommands) {
+        if (keyword == command) return false;
+    }
+    return true;
+}
+
+// Printable form of a request or response, for mismatch reports
+std::string printable(const std::string& data, Capture::Kind kind) {
+    std::string out;
+    for (unsigned char c : data.substr(0, 60)) {
+        char hex[8];
+        if (kind == Capture::TEXT && c >= 32 && c < 127) out += static_cast<char>(c);
+        else if (kind == Capture::TEXT && c == '\n') out += "\\n";
+        else {
+            std::snprintf(hex, sizeof(hex), kind == Capture::TEXT ? "\\x%02x" : "%02x", c);
+            out += hex;
+        }
+    }
+    return data.size() > 60 ? out + "..." : out;
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()));
+    return sorted[index];
+}
+
+void printLatency(const char* label, std::vector<double>& samples) {
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    std::printf("latency us %-7s p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n", label,
+                percentile(samples, 0.50), percentile(samples, 0.90), percentile(samples, 0.99),
+                percentile(samples, 0.999), samples.back());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s <CAPTURE> <PORT|unix:PATH> [CONNECTIONS] [SPEED] [HOST]\n", argv[0]);
+        return 1;
+    }
+    int connections = argc > 3 ? std::atoi(argv[3]) : 4;
+    std::string speedArg = argc > 4 ? argv[4] : "1";
+    const char* host = argc > 5 ? argv[5] : "127.0.0.1";
+    double speed = speedArg == "max" ? 0 : std::atof(speedArg.c_str());
+    if (connections <= 0 || (speedArg != "max" && speed <= 0)) {
+        std::fprintf(stderr, "CONNECTIONS must be positive and SPEED a positive factor or \"max\"\n");
+        return 1;
+    }
+
+    Target target;
+    if (!parseTarget(argv[2], host, target)) {
+        std::fprintf(stderr, "Invalid target %s (host %s)\n", argv[2], host);
+        return 1;
+    }
+
+    std::vector<Capture::Record> records;
+    if (!Capture::load(argv[1], records)) {
+        std::fprintf(stderr, "Can't read capture %s\n", argv[1]);
+        return 1;
+    }
+    if (records.empty()) {
+        std::printf("capture is empty\n");
+        return 0;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<long> mismatches{0}, failures{0}, unverified{0};
+    std::vector<std::vector<double>> textLatency(connections), frameLatency(connections);
+    std::mutex reportMutex;
+    std::vector<std::string> examples;
+
+    Clock::time_point start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < connections; ++t) {
+        workers.emplace_back([&, t]() {
+            int binaryFd = -1;
+            for (size_t i; (i = next.fetch_add(1)) < records.size(); ) {
+                const Capture::Record& record = records[i];
+                Clock::time_point begin = Clock::now();
+                if (speed > 0) {
+                    // Measure from when the request was due, even if we're late sending it
+                    begin = start + std::chrono::microseconds(static_cast<int64_t>(record.timeUs / speed));
+                    std::this_thread::sleep_until(begin);
+                }
+
+                std::string response;
+                bool ok;
+                if (record.kind == Capture::TEXT) {
+                    ok = runText(target, record.request, response);
+                } else {
+                    if (binaryFd < 0) binaryFd = connectTarget(target);
+                    ok = runFrame(binaryFd, record.request, response);
+                }
+                double us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+
+                if (!ok) {
+                    ++failures;
+                    if (record.kind == Capture::FRAME && binaryFd >= 0) {
+                        close(binaryFd);  // The stream may be out of step; start a new connection
+                        binaryFd = -1;
+                    }
+                    continue;
+                }
+                (record.kind == Capture::TEXT ? textLatency : frameLatency)[t].push_back(us);
+
+                if (!verifiable(record)) {
+                    ++unverified;
+                } else if (response != record.response) {
+                    ++mismatches;
+                    std::lock_guard<std::mutex> lock(reportMutex);
+                    if (examples.size() < 5) {
+                        examples.push_back(printable(record.request, record.kind) + "\n    expected " +
+                                           printable(record.response, record.kind) + "\n    got      " +
+                                           printable(response, record.kind));
+                    }
+                }
+            }
+            if (binaryFd >= 0) close(binaryFd);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> text, frames;
+    for (int t = 0; t < connections; ++t) {
+        text.insert(text.end(), textLatency[t].begin(), textLatency[t].end());
+        frames.insert(frames.end(), frameLatency[t].begin(), frameLatency[t].end());
+    }
+
+    std::printf("records %zu (text %zu, binary %zu)  connections %d  speed %s\n", records.size(),
+                text.size(), frames.size(), connections, speedArg.c_str());
+    std::printf("replayed in %.2f s (captured over %.2f s), %.0f req/s\n", seconds,
+                records.back().timeUs / 1e6, records.size() / seconds);
+    std::printf("mismatches %ld  failures %ld  unverified %ld\n", mismatches.load(), failures.load(), unverified.load());
+    printLatency("text", text);
+    printLatency("binary", frames);
+    for (const auto& example : examples) std::printf("mismatch: %s\n", example.c_str());
+
+    return mismatches.load() || failures.load() ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+#include <arpa/inet.h>                 // For inet_pton()
+#include <netinet/in.h>                // For sockaddr_in
+#include <sys/socket.h>                // For socket(), connect(), send(), recv()
+#include <sys/un.h>                    // For sockaddr_un
+#include <unistd.h>                    // For close()
+#include "Server/BinaryProtocol.h"     // Frames for the binary mode
+#include "Client/BlacklistClient.h"    // Pooled, pipelined client for the client mode
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Load generator for the blacklist server.
+ *
+ * Opens one connection per request, exactly like the API's tcpClient.js:
+ * connect, send "GET <url>\n", read until the server half-closes, close.
+ *
+ * Usage: ./server_bench <TARGET> [THREADS] [REQUESTS_PER_THREAD] [HOST] [text|binary|client]
+ *   TARGET is a TCP port, "unix:<path>" or "seqpacket:<path>", so the same
+ *   connect-plus-request latency can be compared across transports.
+ *   In binary mode each thread keeps one connection open and sends GET frames
+ *   on it one at a time, so latency is per request without connection setup.
+ *   In client mode the threads share one BlacklistClient and each keeps
+ *   CLIENT_WINDOW checks outstanding, which the client pipelines and batches;
+ *   latency runs from the call to its future being ready.
+ * Prints throughput and latency percentiles for the whole run.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t CLIENT_WINDOW = 64;   // Checks each thread keeps outstanding in client mode
+
+// Where and how to connect
+struct Target {
+    int family;
+    int type;
+    sockaddr_storage addr;
+    socklen_t addrLen;
+};
+
+// Parses "<port>", "unix:<path>" or "seqpacket:<path>"
+bool parseTarget(const std::string& spec, const char* host, Target& target) {
+    std::memset(&target, 0, sizeof(target));
+
+    bool seqpacket = spec.compare(0, 10, "seqpacket:") == 0;
+    if (seqpacket || spec.compare(0, 5, "unix:") == 0) {
+        std::string path = spec.substr(seqpacket ? 10 : 5);
+        sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&target.addr);
+        if (path.empty() || path.size() >= sizeof(un->sun_path)) return false;
+        un->sun_family = AF_UNIX;
+        std::strncpy(un->sun_path, path.c_str(), sizeof(un->sun_path) - 1);
+        target.family = AF_UNIX;
+        target.type = seqpacket ? SOCK_SEQPACKET : SOCK_STREAM;
+        target.addrLen = sizeof(sockaddr_un);
+        return true;
+    }
+
+    sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&target.addr);
+    in->sin_family = AF_INET;
+    in->sin_port = htons(static_cast<uint16_t>(std::atoi(spec.c_str())));
+    target.family = AF_INET;
+    target.type = SOCK_STREAM;
+    target.addrLen = sizeof(sockaddr_in);
+    return inet_pton(AF_INET, host, &in->sin_addr) == 1;
+}
+
+// Runs one request/response exchange and returns false on any socket error
+bool runRequest(const Target& target, const std::string& request) {
+    int fd = socket(target.family, target.type, 0);
+    if (fd < 0) return false;
+
+    bool ok = connect(fd, reinterpret_cast<const sockaddr*>(&target.addr), target.addrLen) == 0 &&
+              send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size());
+
+    char buffer[4096];
+    ssize_t n;
+    size_t total = 0;
+    while (ok && (n = recv(fd, buffer, sizeof(buffer), 0)) > 0) total += static_cast<size_t>(n);
+
+    close(fd);
+    return ok && total > 0;
+}
+
+// Opens a connection for binary mode
+int connectTarget(const Target& target) {
+    int fd = socket(target.family, target.type, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&target.addr), target.addrLen) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends one binary GET frame and reads its response frame
+bool runBinaryRequest(int fd, uint32_t requestId, const std::string& url) {
+    std::string frame;
+    BinaryProtocol::appendFrame(frame, BinaryProtocol::OP_GET, requestId, url);
+    if (send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(frame.size())) return false;
+
+    char buffer[64];
+    size_t have = 0;
+    BinaryProtocol::Header header;
+    while (true) {
+        ssize_t n = recv(fd, buffer + have, sizeof(buffer) - have, 0);
+        if (n <= 0) return false;
+        have += static_cast<size_t>(n);
+        if (have >= BinaryProtocol::HEADER_SIZE) {
+            if (!BinaryProtocol::decodeHeader(buffer, header)) return false;
+            if (have >= BinaryProtocol::HEADER_SIZE + header.length) break;
+        }
+    }
+    return header.requestId == requestId && header.code == BinaryProtocol::STATUS_OK;
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * sorted.size()));
+    return sorted[index];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <PORT|unix:PATH|seqpacket:PATH> [THREADS] [REQUESTS_PER_THREAD] [HOST] [text|binary|client]\n", argv[0]);
+        return 1;
+    }
+    int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    int requests = argc > 3 ? std::atoi(argv[3]) : 5000;
+    const char* host = argc > 4 ? argv[4] : "127.0.0.1";
+    std::string mode = argc > 5 ? argv[5] : "text";
+    bool binary = mode == "binary";
+
+    Target target;
+    if (!parseTarget(argv[1], host, target) || (mode == "client" && target.type != SOCK_STREAM)) {
+        std::fprintf(stderr, "Invalid target %s (host %s)\n", argv[1], host);
+        return 1;
+    }
+
+    std::unique_ptr<BlacklistClient> client;
+    if (mode == "client") {
+        BlacklistClient::Options options;
+        std::string spec = argv[1];
+        if (target.family == AF_UNIX) options.unixPath = spec.substr(5);
+        else options.port = std::atoi(spec.c_str());
+        options.host = host;
+        client.reset(new BlacklistClient(options));
+    }
+
+    std::vector<std::vector<double>> latencies(threads);
+    std::atomic<long> failures{0};
+    std::vector<std::thread> workers;
+
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            latencies[t].reserve(requests);
+            if (client) {
+                std::deque<std::pair<Clock::time_point, std::future<BlacklistClient::Verdict>>> window;
+                auto finishOldest = [&]() {
+                    try {
+                        window.front().second.get();
+                        latencies[t].push_back(
+                            std::chrono::duration<double, std::micro>(Clock::now() - window.front().first).count());
+                    } catch (const BlacklistClient::Error&) {
+                        ++failures;
+                    }
+                    window.pop_front();
+                };
+                for (int i = 0; i < requests; ++i) {
+                    std::string url = "www.site" + std::to_string((t * requests + i) % 1000) + ".com";
+                    window.emplace_back(Clock::now(), client->check(url));
+                    if (window.size() >= CLIENT_WINDOW) finishOldest();
+                }
+                while (!window.empty()) finishOldest();
+                return;
+            }
+            int fd = binary ? connectTarget(target) : -1;
+            for (int i = 0; i < requests; ++i) {
+                std::string url = "www.site" + std::to_string((t * requests + i) % 1000) + ".com";
+                Clock::time_point begin = Clock::now();
+                bool ok = binary ? fd >= 0 && runBinaryRequest(fd, static_cast<uint32_t>(i), url)
+                                 : runRequest(target, "GET " + url + "\n");
+                if (!ok) {
+                    ++failures;
+                    continue;
+                }
+                latencies[t].push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+            }
+            if (fd >= 0) close(fd);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> all;
+    for (auto& samples : latencies) all.insert(all.end(), samples.begin(), samples.end());
+    std::sort(all.begin(), all.end());
+
+    std::printf("requests %zu  failures %ld  threads %d\n", all.size(), failures.load(), threads);
+    std::printf("throughput %.0f req/s\n", all.size() / seconds);
+    std::printf("latency us  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+                percentile(all, 0.50), percentile(all, 0.90), percentile(all, 0.99), all.empty() ? 0 : all.back());
+    if (client) {
+        BlacklistClient::Stats stats = client->stats();
+        std::printf("client frames %llu  batched checks %llu  retries %llu  timeouts %llu\n",
+                    (unsigned long long)stats.frames, (unsigned long long)stats.batched,
+                    (unsigned long long)stats.retries, (unsigned long long)stats.timeouts);
+    }
+    return failures.load() ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+#include "Bloom/BloomFilter.h"      // Text and snapshot loading under test
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>                 // For unlink()
+
+/**
+ * Start-up time of a filter from the text save file versus the binary snapshot.
+ *
+ * Writes a save file in the server's text format (bit line, hash depths, one
+ * URL per line), times constructing a BloomFilter from it, writes the snapshot
+ * with saveSnapshot(), and times constructing one again, which now maps the
+ * snapshot instead. The files go to the current directory and are removed.
+ *
+ * Usage: ./snapshot_bench [MBITS] [URLS]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t mbits = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    size_t urls = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+    if (mbits == 0) {
+        std::fprintf(stderr, "Usage: %s [MBITS] [URLS]\n", argv[0]);
+        return 1;
+    }
+    size_t bits = mbits << 20;
+    const std::string textFile = "snapshot_bench.txt";
+    const std::string snapFile = "snapshot_bench.snap";
+    std::vector<int> depths{1, 2, 3};
+
+    {
+        std::mt19937_64 rng(7);
+        std::string line(bits, '0');
+        for (size_t i = 0; i < bits; ++i) {
+            if ((rng() & 3) == 0) line[i] = '1';
+        }
+        std::ofstream out(textFile);
+        out << line << "\n1 2 3 \n";
+        for (size_t i = 0; i < urls; ++i) out << "www.site" << i % 9973 << ".com/page/" << i << "\n";
+    }
+
+    auto start = Clock::now();
+    double textSeconds;
+    {
+        BloomFilter filter(bits, depths, textFile);
+        textSeconds = secondsSince(start);
+        filter.saveSnapshot();
+    }
+
+    start = Clock::now();
+    double snapSeconds;
+    {
+        BloomFilter filter(bits, depths, textFile);
+        snapSeconds = secondsSince(start);
+    }
+
+    std::printf("%zu Mbit filter, %zu URLs\n", mbits, urls);
+    std::printf("  load from text save file  %7.1f ms\n", textSeconds * 1000);
+    std::printf("  load from snapshot        %7.1f ms\n", snapSeconds * 1000);
+
+    unlink(textFile.c_str());
+    unlink(snapFile.c_str());
+    return 0;
+}
@@ -0,0 +1,475 @@
+#include "Server/ConnectionHandler.h"    // In-process entry points shared by every I/O backend
+#include "Server/BinaryProtocol.h"       // Frames for binary requests
+#include "Client/BlacklistClient.h"      // Binary and text requests to a running server
+#include "Bloom/Namespaces.h"            // Filters for the in-process target
+
+#include <dirent.h>                      // For opendir(), to clean up the data directory
+#include <stdlib.h>                      // For mkdtemp()
+#include <unistd.h>                      // For rmdir(), unlink()
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Concurrency stress test and linearizability checker for the filter and the server.
+ *
+ * THREADS workers run random GET, POST and DELETE requests on KEYS URLs, half
+ * of them in the default namespace and half in a second one ("stress"), in
+ * rounds of one second. Every request is recorded with logical call and return
+ * times. After each round, a sequential GET of every URL closes the round and
+ * fixes the state the next one starts from, and the history is checked against
+ * a sequential set: POST adds the URL, DELETE removes it and answers whether it
+ * was there, and GET answers "true true" exactly when it is there. URLs are
+ * independent and linearizability is local, so each URL's history is checked
+ * on its own, with the Wing & Gong search and Lowe's memoization. A GET that
+ * missed a URL every valid order has present (a false negative) is called out.
+ *
+ * Targets:
+ *  - filter: in process, through ConnectionHandler::processLine() and
+ *    processFrames(), so the verdict cache, the false positive memo and the
+ *    filter lock are all exercised without sockets. The filters are tiny, so
+ *    false positives are common.
+ *  - server: a running server, over binary frames sent with BlacklistClient
+ *    and text commands on their own connections.
+ *
+ * Configure with -DSANITIZE_THREAD=ON to run this and the server under
+ * ThreadSanitizer. TTLs aren't exercised: the model has no clock.
+ *
+ * Usage: ./stress filter [THREADS] [SECONDS] [KEYS] [--soak]
+ *        ./stress server <PORT|unix:PATH> [THREADS] [SECONDS] [KEYS] [HOST] [--soak]
+ *   --soak prints throughput and the check result for every round.
+ * Exits with 1 if a history wasn't linearizable or a request failed.
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const NAMESPACE = "stress";
+const size_t FILTER_BITS = 256;          // Tiny filters for the in-process target: many false positives
+
+enum Kind : uint8_t { READ, ADD, REMOVE };
+enum Channel : uint8_t { TEXT, BINARY };
+
+// One request and what it returned
+struct Op {
+    uint32_t key;
+    Kind kind;
+    Channel channel;
+    bool result;          // READ: listed; REMOVE: was listed; ADD: always true
+    bool falsePositive;   // READ answered "true false"
+    uint64_t call;        // Logical times: an op that returned before another was called has the smaller ret
+    uint64_t ret;
+};
+
+std::atomic<uint64_t> logicalClock{0};
+
+std::string urlOf(uint32_t key) {
+    return "https://stress" + std::to_string(key % 7) + ".example.com/k" + std::to_string(key);
+}
+
+// Odd keys live in the second namespace, which only the text protocol reaches
+bool namespaced(uint32_t key) {
+    return key % 2 == 1;
+}
+
+std::string textCommand(const Op& op) {
+    static const char* const verbs[] = {"GET ", "POST ", "DELETE "};
+    std::string line = verbs[op.kind];
+    if (namespaced(op.key)) line += std::string(NAMESPACE) + " ";
+    return line + urlOf(op.key);
+}
+
+bool parseText(const std::string& response, Op& op) {
+    switch (op.kind) {
+        case READ:
+            if (response.compare(0, 8, "200 Ok\n\n") != 0) return false;
+            op.result = response.compare(8, 9, "true true") == 0;
+            op.falsePositive = response.compare(8, 10, "true false") == 0;
+            return op.result || op.falsePositive || response.compare(8, 5, "false") == 0;
+        case ADD:
+            op.result = true;
+            return response.compare(0, 11, "201 Created") == 0;
+        default:
+            op.result = response.compare(0, 3, "204") == 0;
+            return op.result || response.compare(0, 3, "404") == 0;
+    }
+}
+
+bool parseBinary(uint8_t status, uint8_t verdict, Op& op) {
+    using namespace BinaryProtocol;
+    switch (op.kind) {
+        case READ:
+            op.result = verdict == VERDICT_BLACKLISTED;
+            op.falsePositive = verdict == VERDICT_FALSE_POSITIVE;
+            return status == STATUS_OK;
+        case ADD:
+            op.result = true;
+            return status == STATUS_CREATED;
+        default:
+            op.result = status == STATUS_NO_CONTENT;
+            return op.result || status == STATUS_NOT_FOUND;
+    }
+}
+
+// Where requests go
+class Target {
+public:
+    virtual ~Target() = default;
+
+    // Runs the request and fills in its result; false if it failed or got an unexpected answer
+    virtual bool run(Op& op) = 0;
+};
+
+// The server's command path, in process
+class FilterTarget : public Target {
+public:
+    FilterTarget() {
+        char pattern[] = "/tmp/stress.XXXXXX";
+        dataDir = mkdtemp(pattern) ? pattern : ".";
+        namespaces.reset(new Namespaces(FILTER_BITS, {1, 2, 3}, dataDir, ExpiryConfig(), MemoryConfig(), 4096, 1024));
+        namespaces->create(NAMESPACE, FILTER_BITS, {1, 2, 3});
+    }
+
+    ~FilterTarget() override {
+        namespaces.reset();
+        if (DIR* dir = opendir(dataDir.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                if (entry->d_name[0] != '.') unlink((dataDir + "/" + entry->d_name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(dataDir.c_str());
+    }
+
+    bool run(Op& op) override {
+        if (op.channel == TEXT) return parseText(ConnectionHandler::processLine(textCommand(op), namespaces.get(), &mutex), op);
+
+        using namespace BinaryProtocol;
+        static const uint8_t opcodes[] = {OP_GET, OP_POST, OP_DELETE};
+        std::string in, out;
+        appendFrame(in, opcodes[op.kind], 1, urlOf(op.key));
+        Header header;
+        if (!ConnectionHandler::processFrames(in, out, namespaces.get(), &mutex) || out.size() < HEADER_SIZE ||
+            !decodeHeader(out.data(), header)) {
+            return false;
+        }
+        return parseBinary(header.code, out.size() > HEADER_SIZE ? out[HEADER_SIZE] : 0, op);
+    }
+
+private:
+    std::string dataDir;
+    std::unique_ptr<Namespaces> namespaces;
+    std::mutex mutex;
+};
+
+// A running server
+class ServerTarget : public Target {
+public:
+    explicit ServerTarget(const BlacklistClient::Options& options) : client(options) {
+        try {
+            client.command("CREATE " + std::string(NAMESPACE) + " " + std::to_string(FILTER_BITS) + " 1 2 3");
+        } catch (const BlacklistClient::Error&) {
+            // The first round's requests report it
+        }
+    }
+
+    bool run(Op& op) override {
+        try {
+            if (op.channel == TEXT) return parseText(client.command(textCommand(op)), op);
+
+            // Retries are off: a request sent twice would not match the one recorded
+            std::promise<BlacklistClient::Reply> done;
+            std::future<BlacklistClient::Reply> reply = done.get_future();
+            auto callback = [&done](const BlacklistClient::Reply& r) { done.set_value(r); };
+            if (op.kind == READ) client.check(urlOf(op.key), callback);
+            else if (op.kind == ADD) client.add(urlOf(op.key), 0, callback);
+            else client.remove(urlOf(op.key), callback);
+            BlacklistClient::Reply r = reply.get();
+            return r.ok && parseBinary(r.status, r.verdict, op);
+        } catch (const BlacklistClient::Error&) {
+            return false;
+        }
+    }
+
+private:
+    BlacklistClient client;
+};
+
+// Sequential specification: the URL is listed or not
+bool step(bool listed, const Op& op, bool& next) {
+    switch (op.kind) {
+        case READ: next = listed; return op.result == listed;
+        case ADD: next = true; return true;
+        default: next = false; return op.result == listed;
+    }
+}
+
+/**
+ * Wing & Gong linearizability search with Lowe's memoization (as in Porcupine)
+ * over one URL's history. Calls and returns form a linked list in time order;
+ * the search linearizes any call that comes before the first pending return
+ * and the model accepts, backtracks when a return is reached, and skips
+ * (linearized set, state) pairs it has already explored.
+ */
+bool linearizable(const std::vector<Op>& ops, bool initial) {
+    const size_t NONE = SIZE_MAX;
+    struct Entry {
+        size_t op;
+        bool call;
+        uint64_t time;
+        size_t match, prev, next;
+    };
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        entries.push_back({i, true, ops[i].call, 0, 0, 0});
+        entries.push_back({i, false, ops[i].ret, 0, 0, 0});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+    std::vector<size_t> callAt(ops.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].call) callAt[entries[i].op] = i;
+        else entries[callAt[entries[i].op]].match = i;
+    }
+    const size_t head = entries.size();
+    entries.push_back({NONE, false, 0, NONE, NONE, entries.empty() ? NONE : 0});
+    for (size_t i = 0; i < head; ++i) {
+        entries[i].prev = i == 0 ? head : i - 1;
+        entries[i].next = i + 1 < head ? i + 1 : NONE;
+    }
+
+    auto unlink = [&](size_t e) {
+        entries[entries[e].prev].next = entries[e].next;
+        if (entries[e].next != NONE) entries[entries[e].next].prev = entries[e].prev;
+    };
+    auto relink = [&](size_t e) {
+        entries[entries[e].prev].next = e;
+        if (entries[e].next != NONE) entries[entries[e].next].prev = e;
+    };
+
+    std::string linearized((ops.size() + 7) / 8 + 1, '\0');  // A bit per op, then the state
+    std::unordered_set<std::string> seen;
+    std::vector<std::pair<size_t, bool>> stack;                // Call linearized, state before it
+    bool state = initial;
+    size_t e = entries[head].next;
+    while (entries[head].next != NONE) {
+        const Entry& entry = entries[e];
+        if (entry.call) {
+            bool next;
+            if (step(state, ops[entry.op], next)) {
+                linearized[entry.op / 8] ^= static_cast<char>(1 << (entry.op % 8));
+                linearized.back() = next;
+                if (seen.insert(linearized).second) {
+                    stack.emplace_back(e, state);
+                    state = next;
+                    unlink(e);
+                    unlink(entry.match);
+                    e = entries[head].next;
+                    continue;
+                }
+                linearized[entry.op / 8] ^= static_cast<char>(1 << (entry.op % 8));
+            }
+            e = entry.next;
+        } else {
+            if (stack.empty()) return false;
+            size_t call = stack.back().first;
+            state = stack.back().second;
+            stack.pop_back();
+            linearized[entries[call].op / 8] ^= static_cast<char>(1 << (entries[call].op % 8));
+            relink(entries[call].match);
+            relink(call);
+            e = entries[call].next;
+        }
+    }
+    return true;
+}
+
+// GETs that missed the URL although a POST had returned before them and no DELETE could come in between
+size_t falseNegatives(const std::vector<Op>& ops) {
+    size_t found = 0;
+    for (const Op& get : ops) {
+        if (get.kind != READ || get.result) continue;
+        for (const Op& add : ops) {
+            if (add.kind != ADD || add.ret > get.call) continue;
+            bool removable = std::any_of(ops.begin(), ops.end(), [&](const Op& del) {
+                return del.kind == REMOVE && del.call < get.ret && del.ret > add.call;
+            });
+            if (!removable) {
+                ++found;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+struct RoundResult {
+    size_t ops = 0;
+    size_t failures = 0;
+    size_t falsePositives = 0;
+    size_t violations = 0;      // URLs whose history isn't linearizable
+    size_t falseNegatives = 0;
+    double seconds = 0;
+};
+
+// Reads every URL in turn and returns the reads, which end the round
+std::vector<Op> readAll(Target& target, size_t keys, size_t& failures) {
+    std::vector<Op> reads;
+    for (uint32_t key = 0; key < keys; ++key) {
+        Op op{key, READ, namespaced(key) ? TEXT : BINARY, false, false, 0, 0};
+        op.call = logicalClock++;
+        bool ok = target.run(op);
+        op.ret = logicalClock++;
+        if (ok) reads.push_back(op);
+        else ++failures;
+    }
+    return reads;
+}
+
+RoundResult runRound(Target& target, int threads, size_t keys, std::vector<bool>& listed, unsigned seed) {
+    RoundResult result;
+    std::vector<std::vector<Op>> histories(threads);
+    std::vector<size_t> failures(threads, 0);
+    std::atomic<bool> stop{false};
+
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 rng(seed * 7919 + t);
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint32_t key = rng() % keys;
+                unsigned dice = rng() % 100;
+                Kind kind = dice < 60 ? READ : dice < 85 ? ADD : REMOVE;
+                Channel channel = namespaced(key) || rng() % 2 ? TEXT : BINARY;
+                Op op{key, kind, channel, false, false, 0, 0};
+                op.call = logicalClock++;
+                bool ok = target.run(op);
+                op.ret = logicalClock++;
+                if (ok) histories[t].push_back(op);
+                else ++failures[t];
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    stop = true;
+    for (auto& worker : workers) worker.join();
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<std::vector<Op>> byKey(keys);
+    for (int t = 0; t < threads; ++t) {
+        result.failures += failures[t];
+        for (const Op& op : histories[t]) {
+            byKey[op.key].push_back(op);
+            ++result.ops;
+            if (op.falsePositive) ++result.falsePositives;
+        }
+    }
+    std::vector<Op> closing = readAll(target, keys, result.failures);
+    for (const Op& read : closing) byKey[read.key].push_back(read);
+    for (auto& ops : byKey) {
+        std::sort(ops.begin(), ops.end(), [](const Op& a, const Op& b) { return a.call < b.call; });
+    }
+
+    // A failed request may or may not have taken effect, which the model can't follow
+    if (result.failures) {
+        for (const Op& read : closing) listed[read.key] = read.result;
+        return result;
+    }
+
+    for (uint32_t key = 0; key < keys; ++key) {
+        if (linearizable(byKey[key], listed[key])) {
+            listed[key] = byKey[key].back().result;  // The closing read
+            continue;
+        }
+        ++result.violations;
+        size_t missed = falseNegatives(byKey[key]);
+        result.falseNegatives += missed;
+        std::fprintf(stderr, "not linearizable: %s (%zu ops, %zu false negatives, listed at start: %s)\n",
+                     urlOf(key).c_str(), byKey[key].size(), missed, listed[key] ? "yes" : "no");
+        static const char* const names[] = {"GET", "POST", "DELETE"};
+        for (size_t i = 0; i < std::min<size_t>(byKey[key].size(), 40); ++i) {
+            const Op& op = byKey[key][i];
+            std::fprintf(stderr, "  [%llu, %llu] %s %s -> %s\n", (unsigned long long)op.call,
+                         (unsigned long long)op.ret, op.channel == TEXT ? "text" : "binary", names[op.kind],
+                         op.result ? "true" : "false");
+        }
+        listed[key] = byKey[key].back().result;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args;
+    bool soak = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--soak") soak = true;
+        else args.push_back(argv[i]);
+    }
+    bool server = !args.empty() && args[0] == "server";
+    if (args.empty() || (args[0] != "filter" && !server) || (server && args.size() < 2)) {
+        std::fprintf(stderr, "Usage: %s filter [THREADS] [SECONDS] [KEYS] [--soak]\n"
+                             "       %s server <PORT|unix:PATH> [THREADS] [SECONDS] [KEYS] [HOST] [--soak]\n",
+                     argv[0], argv[0]);
+        return 1;
+    }
+    size_t first = server ? 2 : 1;
+    auto arg = [&](size_t i, const char* fallback) { return first + i < args.size() ? args[first + i] : fallback; };
+    int threads = std::max(1, std::atoi(arg(0, "8").c_str()));
+    int seconds = std::max(1, std::atoi(arg(1, soak ? "600" : "10").c_str()));
+    size_t keys = std::max(2, std::atoi(arg(2, "64").c_str()));
+
+    std::unique_ptr<Target> target;
+    if (server) {
+        BlacklistClient::Options options;
+        if (args[1].compare(0, 5, "unix:") == 0) options.unixPath = args[1].substr(5);
+        else options.port = std::atoi(args[1].c_str());
+        options.host = arg(3, "127.0.0.1");
+        options.retries = 0;
+        options.timeout = std::chrono::milliseconds(10000);
+        target.reset(new ServerTarget(options));
+    } else {
+        target.reset(new FilterTarget);
+    }
+
+    // The state every URL starts from
+    size_t failures = 0;
+    std::vector<bool> listed(keys, false);
+    for (const Op& read : readAll(*target, keys, failures)) listed[read.key] = read.result;
+
+    std::printf("%s, %d threads, %zu URLs, %d rounds of 1 s\n", server ? "server" : "filter", threads, keys, seconds);
+    RoundResult total;
+    for (int round = 0; round < seconds; ++round) {
+        RoundResult result = runRound(*target, threads, keys, listed, static_cast<unsigned>(round));
+        total.ops += result.ops;
+        total.failures += result.failures;
+        total.falsePositives += result.falsePositives;
+        total.violations += result.violations;
+        total.falseNegatives += result.falseNegatives;
+        total.seconds += result.seconds;
+        if (soak) {
+            std::printf("  %5d s  %9.0f ops/s  false positives %zu  failures %zu  violations %zu%s\n", round + 1,
+                        result.ops / result.seconds, result.falsePositives, result.failures, result.violations,
+                        result.failures ? "  (not checked)" : "");
+            std::fflush(stdout);
+        }
+    }
+
+    std::printf("ops %zu  %.0f ops/s  false positives %zu  failures %zu\n", total.ops, total.ops / total.seconds,
+                total.falsePositives, total.failures + failures);
+    std::printf("linearizability violations %zu  false negatives %zu\n", total.violations, total.falseNegatives);
+    return total.violations || total.failures || failures ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#include "Trace/Trace.h"            // Span recording under test
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Cost of recording request spans.
+ *
+ * Times Trace::now() and Trace::record() with tracing on and off, on one
+ * thread and on several at once (each thread writes its own ring, so they
+ * should scale without contention), then times one TRACE DUMP of full rings.
+ * A text request records 6 spans, so 6x the record cost is the per-request
+ * overhead to compare against the server's request latency.
+ *
+ * Usage: ./trace_bench [SPANS_PER_THREAD] [THREADS]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Records `spans` spans and returns the average ns per span (timestamps included)
+double recordCost(size_t spans) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < spans; ++i) {
+        uint64_t t0 = Trace::now();
+        Trace::record(Trace::EXECUTE, "bench", t0, Trace::now(), static_cast<uint32_t>(i));
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / spans;
+}
+
+double parallelCost(size_t spans, int threads) {
+    std::vector<double> costs(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&costs, t, spans]() { costs[t] = recordCost(spans); });
+    }
+    for (auto& worker : workers) worker.join();
+
+    double total = 0;
+    for (double cost : costs) total += cost;
+    return total / threads;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t spans = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000000;
+    int threads = argc > 2 ? std::atoi(argv[2]) : 4;
+    if (spans == 0 || threads <= 0) {
+        std::fprintf(stderr, "Usage: %s [SPANS_PER_THREAD] [THREADS]\n", argv[0]);
+        return 1;
+    }
+
+    Trace::setEnabled(false);
+    double off = recordCost(spans);
+
+    Trace::setEnabled(true);
+    recordCost(spans / 10);  // Create this thread's ring and warm it up
+    double on = recordCost(spans);
+    double parallel = parallelCost(spans, threads);
+
+    auto start = Clock::now();
+    std::string json = Trace::dumpChromeJson();
+    double dumpMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::printf("ns per span (two timestamps + record)\n");
+    std::printf("  tracing off          %6.1f\n", off);
+    std::printf("  tracing on, 1 thread %6.1f\n", on);
+    std::printf("  tracing on, %d threads %5.1f\n", threads, parallel);
+    std::printf("  => about %.0f ns per text request (6 spans)\n\n", 6 * on);
+    std::printf("TRACE DUMP of %d rings: %.1f ms, %zu KiB of JSON\n",
+                threads + 1, dumpMs, json.size() / 1024);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "Scan/UrlScanner.h"       // Scanner under test
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Throughput of the URL scanner behind SCAN, on generated mail text.
+ *
+ * Builds a body of words, sentences and the occasional URL (with and without
+ * a scheme or path, some followed by punctuation), then scans it with each
+ * dot search this CPU supports, fed in 4 KiB chunks as the server receives it
+ * and in a single call. Every run must find the same URLs.
+ *
+ * Usage: ./url_scanner_bench [MIB] [WORDS_PER_URL]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string mailText(size_t bytes, size_t wordsPerUrl, unsigned seed) {
+    static const char* const words[] = {
+        "the", "invoice", "attached", "please", "review", "meeting", "tomorrow", "at", "regards",
+        "account", "password", "update", "your", "we", "noticed", "unusual", "activity", "on", "click",
+        "below", "thanks", "team", "schedule", "v2.1", "e.g.", "Q3", "report", "and", "for", "i.e."};
+    static const char* const schemes[] = {"", "", "http://", "https://", "https://www."};
+    static const char* const tails[] = {"", "", ".", ",", ")", "/", "/login", "/a/b?c=d&e=f", "/path/page.html."};
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    std::mt19937_64 rng(seed);
+    std::string text;
+    text.reserve(bytes + 256);
+    size_t sentence = 0;
+    while (text.size() < bytes) {
+        if (rng() % wordsPerUrl == 0) {
+            text += schemes[rng() % 5];
+            text += "site" + std::to_string(rng() % 100000) + (rng() % 3 ? ".com" : ".co.uk");
+            text += tails[rng() % 9];
+        } else {
+            text += words[rng() % wordCount];
+        }
+        if (++sentence % 12 == 0) text += ".";
+        text += rng() % 20 ? " " : "\n";
+    }
+    return text;
+}
+
+struct Run {
+    double gbPerSecond;
+    std::vector<std::string> urls;
+};
+
+Run scan(const std::string& text, UrlScanner::Simd simd, size_t chunk) {
+    Run best{0, {}};
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        auto start = Clock::now();
+        UrlScanner scanner(simd);
+        for (size_t offset = 0; offset < text.size(); offset += chunk) {
+            scanner.feed(text.data() + offset, std::min(chunk, text.size() - offset));
+        }
+        scanner.finish();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        best.gbPerSecond = std::max(best.gbPerSecond, text.size() / seconds / 1e9);
+        best.urls = scanner.urls();
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t mib = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    size_t wordsPerUrl = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    if (mib == 0 || wordsPerUrl == 0) {
+        std::fprintf(stderr, "Usage: %s [MIB] [WORDS_PER_URL]\n", argv[0]);
+        return 1;
+    }
+    std::string text = mailText(mib << 20, wordsPerUrl, 42);
+
+    std::vector<UrlScanner::Simd> variants{UrlScanner::Simd::SCALAR};
+    if (UrlScanner::best() != UrlScanner::Simd::SCALAR) variants.push_back(UrlScanner::Simd::SSE2);
+    if (UrlScanner::best() == UrlScanner::Simd::AVX2) variants.push_back(UrlScanner::Simd::AVX2);
+
+    std::printf("%zu MiB of text, a URL every %zu words\n", mib, wordsPerUrl);
+    std::vector<std::string> reference;
+    int status = 0;
+    for (UrlScanner::Simd simd : variants) {
+        for (size_t chunk : {size_t(4096), text.size()}) {
+            Run run = scan(text, simd, chunk);
+            if (reference.empty()) reference = run.urls;
+            bool same = run.urls == reference;
+            std::printf("  %-6s %-8s %6.2f GB/s  %zu distinct URLs%s\n", UrlScanner::name(simd),
+                        chunk == text.size() ? "whole" : "4 KiB", run.gbPerSecond, run.urls.size(),
+                        same ? "" : "  DIFFERENT URLS");
+            if (!same) status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,131 @@
+#include "Bloom/BloomFilter.h"      // Filter answering the misses
+#include "Bloom/FilterKernel.h"     // Bit indices for the save file
+#include "Bloom/VerdictCache.h"     // Cache under test
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>                 // For unlink()
+
+/**
+ * Cost of a GET with and without the verdict cache, on a Zipf-distributed trace.
+ *
+ * Builds a filter in which every fourth URL rank is blacklisted (written as a
+ * text save file, with the bits the server would have set), then replays the
+ * same trace through the server's locked GET path (mutex, expire, check,
+ * doubleCheck) and through a VerdictCache of several sizes in front of it.
+ * Cached runs start cold and must give the same verdict for every GET.
+ *
+ * Usage: ./verdict_cache_bench [DISTINCT_URLS] [GETS]
+ */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string urlOf(size_t rank) {
+    return "https://www.site" + std::to_string(rank % 997) + ".com/page/" + std::to_string(rank);
+}
+
+// Rank 0 is the most popular URL; P(rank) is proportional to 1 / (rank + 1)
+std::vector<std::string> zipfTrace(size_t gets, size_t distinct, unsigned seed) {
+    std::vector<double> cdf(distinct);
+    double total = 0;
+    for (size_t i = 0; i < distinct; ++i) cdf[i] = total += 1.0 / double(i + 1);
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0, total);
+    std::vector<std::string> trace;
+    trace.reserve(gets);
+    for (size_t i = 0; i < gets; ++i) {
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+        trace.push_back(urlOf(std::min(rank, distinct - 1)));
+    }
+    return trace;
+}
+
+std::mutex filterMutex;
+
+VerdictCache::Verdict lockedGet(BloomFilter& filter, const std::string& url) {
+    std::lock_guard<std::mutex> lock(filterMutex);
+    filter.expire();
+    if (!filter.check(url)) return VerdictCache::ABSENT;
+    return filter.doubleCheck(url) ? VerdictCache::BLACKLISTED : VerdictCache::FALSE_POSITIVE;
+}
+
+double nsPerGet(Clock::time_point start, size_t gets) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / gets;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t distinct = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t gets = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+    if (distinct == 0 || gets == 0) {
+        std::fprintf(stderr, "Usage: %s [DISTINCT_URLS] [GETS]\n", argv[0]);
+        return 1;
+    }
+    const std::string saveFile = "verdict_cache_bench.txt";
+    const size_t bits = size_t(1) << 22;
+    std::vector<int> depths{1, 2, 3};
+
+    {
+        FilterKernel::Kernel kernel = FilterKernel::select(depths, bits, FilterKernel::layoutPreserving(bits));
+        std::string line(bits, '0');
+        std::vector<uint64_t> indices(depths.size());
+        std::ofstream out(saveFile);
+        std::string urls;
+        for (size_t rank = 0; rank < distinct; rank += 4) {
+            std::string url = urlOf(rank);
+            kernel.indices(kernel, url, indices.data());
+            for (uint64_t index : indices) line[index] = '1';
+            urls += url + "\n";
+        }
+        out << line << "\n1 2 3 \n" << urls;
+    }
+
+    BloomFilter filter(bits, depths, saveFile);
+    std::vector<std::string> trace = zipfTrace(gets, distinct, 42);
+
+    std::vector<VerdictCache::Verdict> expected(gets);
+    auto start = Clock::now();
+    for (size_t i = 0; i < gets; ++i) expected[i] = lockedGet(filter, trace[i]);
+    double uncached = nsPerGet(start, gets);
+
+    size_t falsePositives = std::count(expected.begin(), expected.end(), VerdictCache::FALSE_POSITIVE);
+    std::printf("%zu distinct URLs, %zu GETs, %.1f%% false positives\n", distinct, gets,
+                100.0 * falsePositives / gets);
+    std::printf("  %-18s %8.1f ns/GET\n", "uncached", uncached);
+
+    int status = 0;
+    for (size_t entries : {size_t(4096), size_t(65536), size_t(1) << 20}) {
+        VerdictCache cache(entries);
+        size_t wrong = 0;
+        start = Clock::now();
+        for (size_t i = 0; i < gets; ++i) {
+            VerdictCache::Verdict verdict;
+            if (!cache.lookup(trace[i], filter, verdict)) {
+                verdict = lockedGet(filter, trace[i]);
+                std::lock_guard<std::mutex> lock(filterMutex);
+                cache.insert(trace[i], verdict, filter);
+            }
+            if (verdict != expected[i]) ++wrong;
+        }
+        double cached = nsPerGet(start, gets);
+
+        VerdictCache::Stats stats = cache.stats();
+        std::printf("  cache %-12zu %8.1f ns/GET  hit rate %5.1f%%  evictions %llu%s\n", cache.capacity(), cached,
+                    100.0 * stats.hits / (stats.hits + stats.misses), (unsigned long long)stats.evictions,
+                    wrong ? "  WRONG VERDICTS" : "");
+        if (wrong) status = 1;
+    }
+
+    unlink(saveFile.c_str());
+    return status;
+}
@@ -0,0 +1,221 @@
+#include "Bloom/BloomFilter.h"        // The filter shared with the TCP server
+#include <node_api.h>                 // Node's C addon API (ABI-stable across Node versions)
+
+#include <string>
+#include <vector>
+
+/**
+ * Thin N-API binding that exposes BloomFilter in-process to the Node API,
+ * so colocated deployments can check URLs without a TCP round trip.
+ *
+ * JavaScript usage:
+ *   const { BloomFilter } = require('./bloom.node');
+ *   const bloom = new BloomFilter('data/filter_data.txt', 16, [1], { readOnly: true });
+ *   bloom.check(url); bloom.doubleCheck(url); bloom.checkBatch([url1, url2]);
+ *
+ * The filter is loaded from the same save file the TCP server writes. In read-only
+ * mode add/remove throw, and reload() picks up the server's latest saved state.
+ */
+namespace {
+
+// Per-instance state wrapped inside the JavaScript object
+struct AddonFilter {
+    BloomFilter filter;
+    bool readOnly;
+};
+
+// Throws a JavaScript error (if one isn't already pending) and returns undefined
+napi_value throwError(napi_env env, const char* message) {
+    bool pending = false;
+    napi_is_exception_pending(env, &pending);
+    if (!pending) napi_throw_error(env, nullptr, message);
+    return nullptr;
+}
+
+// Reads a JavaScript string argument into a std::string
+bool readString(napi_env env, napi_value value, std::string& out) {
+    size_t length = 0;
+    if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) return false;
+    out.resize(length);
+    return napi_get_value_string_utf8(env, value, &out[0], length + 1, &length) == napi_ok;
+}
+
+// Reads a JavaScript array of strings
+bool readStringArray(napi_env env, napi_value value, std::vector<std::string>& out) {
+    bool isArray = false;
+    if (napi_is_array(env, value, &isArray) != napi_ok || !isArray) return false;
+
+    uint32_t length = 0;
+    napi_get_array_length(env, value, &length);
+    out.resize(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        napi_value element;
+        if (napi_get_element(env, value, i, &element) != napi_ok || !readString(env, element, out[i])) return false;
+    }
+    return true;
+}
+
+napi_value makeBool(napi_env env, bool value) {
+    napi_value result;
+    napi_get_boolean(env, value, &result);
+    return result;
+}
+
+// Unwraps `this` and up to `max` arguments for a method call
+AddonFilter* unwrapCall(napi_env env, napi_callback_info info, size_t max, napi_value* args, size_t& argc) {
+    napi_value self;
+    argc = max;
+    if (napi_get_cb_info(env, info, &argc, args, &self, nullptr) != napi_ok) return nullptr;
+
+    void* native = nullptr;
+    if (napi_unwrap(env, self, &native) != napi_ok) return nullptr;
+    return static_cast<AddonFilter*>(native);
+}
+
+// Shared body of the single-URL methods: fn(filter, url) -> bool
+template <typename Fn>
+napi_value singleUrl(napi_env env, napi_callback_info info, bool mutates, Fn fn) {
+    napi_value args[1];
+    size_t argc;
+    AddonFilter* self = unwrapCall(env, info, 1, args, argc);
+    if (!self) return throwError(env, "Invalid BloomFilter instance");
+    if (mutates && self->readOnly) return throwError(env, "BloomFilter was opened read-only");
+
+    std::string url;
+    if (argc < 1 || !readString(env, args[0], url)) return throwError(env, "Expected a URL string");
+    return makeBool(env, fn(self->filter, url));
+}
+
+// Shared body of the batch methods: maps fn over an array of URLs, returns an array of booleans
+template <typename Fn>
+napi_value batchUrls(napi_env env, napi_callback_info info, bool mutates, Fn fn) {
+    napi_value args[1];
+    size_t argc;
+    AddonFilter* self = unwrapCall(env, info, 1, args, argc);
+    if (!self) return throwError(env, "Invalid BloomFilter instance");
+    if (mutates && self->readOnly) return throwError(env, "BloomFilter was opened read-only");
+
+    std::vector<std::string> urls;
+    if (argc < 1 || !readStringArray(env, args[0], urls)) return throwError(env, "Expected an array of URL strings");
+
+    napi_value result;
+    napi_create_array_with_length(env, urls.size(), &result);
+    for (size_t i = 0; i < urls.size(); ++i) {
+        napi_set_element(env, result, static_cast<uint32_t>(i), makeBool(env, fn(self->filter, urls[i])));
+    }
+    return result;
+}
+
+bool doCheck(BloomFilter& f, const std::string& url) { return f.check(url); }
+bool doDoubleCheck(BloomFilter& f, const std::string& url) { return f.doubleCheck(url); }
+bool doAdd(BloomFilter& f, const std::string& url) { f.add(url); return true; }
+bool doRemove(BloomFilter& f, const std::string& url) { return f.remove(url); }
+
+napi_value Check(napi_env env, napi_callback_info info) { return singleUrl(env, info, false, doCheck); }
+napi_value DoubleCheck(napi_env env, napi_callback_info info) { return singleUrl(env, info, false, doDoubleCheck); }
+napi_value Add(napi_env env, napi_callback_info info) { return singleUrl(env, info, true, doAdd); }
+napi_value Remove(napi_env env, napi_callback_info info) { return singleUrl(env, info, true, doRemove); }
+napi_value CheckBatch(napi_env env, napi_callback_info info) { return batchUrls(env, info, false, doCheck); }
+napi_value DoubleCheckBatch(napi_env env, napi_callback_info info) { return batchUrls(env, info, false, doDoubleCheck); }
+napi_value AddBatch(napi_env env, napi_callback_info info) { return batchUrls(env, info, true, doAdd); }
+napi_value RemoveBatch(napi_env env, napi_callback_info info) { return batchUrls(env, info, true, doRemove); }
+
+// Re-reads the save file, e.g. after the TCP server persisted a change
+napi_value Reload(napi_env env, napi_callback_info info) {
+    size_t argc;
+    AddonFilter* self = unwrapCall(env, info, 0, nullptr, argc);
+    if (!self) return throwError(env, "Invalid BloomFilter instance");
+    self->filter.reload();
+    return nullptr;
+}
+
+// Returns the filter version as a BigInt (it doesn't fit a double)
+napi_value Version(napi_env env, napi_callback_info info) {
+    size_t argc;
+    AddonFilter* self = unwrapCall(env, info, 0, nullptr, argc);
+    if (!self) return throwError(env, "Invalid BloomFilter instance");
+
+    napi_value result;
+    napi_create_bigint_uint64(env, self->filter.getVersion(), &result);
+    return result;
+}
+
+void Finalize(napi_env, void* data, void*) {
+    delete static_cast<AddonFilter*>(data);
+}
+
+// new BloomFilter(saveFile, size, depths[, { readOnly }])
+napi_value Construct(napi_env env, napi_callback_info info) {
+    napi_value args[4];
+    napi_value self;
+    size_t argc = 4;
+    napi_get_cb_info(env, info, &argc, args, &self, nullptr);
+    if (argc < 3) return throwError(env, "Expected (saveFile, size, depths[, options])");
+
+    std::string saveFile;
+    if (!readString(env, args[0], saveFile)) return throwError(env, "saveFile must be a string");
+
+    int64_t size = 0;
+    if (napi_get_value_int64(env, args[1], &size) != napi_ok || size <= 0) {
+        return throwError(env, "size must be a positive integer");
+    }
+
+    bool isArray = false;
+    napi_is_array(env, args[2], &isArray);
+    if (!isArray) return throwError(env, "depths must be an array of positive integers");
+    uint32_t count = 0;
+    napi_get_array_length(env, args[2], &count);
+    std::vector<int> depths;
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value element;
+        int32_t depth = 0;
+        napi_get_element(env, args[2], i, &element);
+        if (napi_get_value_int32(env, element, &depth) != napi_ok || depth <= 0) {
+            return throwError(env, "depths must be an array of positive integers");
+        }
+        depths.push_back(depth);
+    }
+    if (depths.empty()) return throwError(env, "depths must not be empty");
+
+    bool readOnly = false;
+    if (argc > 3) {
+        napi_value flag;
+        bool hasFlag = false;
+        napi_has_named_property(env, args[3], "readOnly", &hasFlag);
+        if (hasFlag && napi_get_named_property(env, args[3], "readOnly", &flag) == napi_ok) {
+            napi_get_value_bool(env, flag, &readOnly);
+        }
+    }
+
+    AddonFilter* native = new AddonFilter{BloomFilter(static_cast<size_t>(size), depths, saveFile), readOnly};
+    if (napi_wrap(env, self, native, Finalize, nullptr, nullptr) != napi_ok) {
+        delete native;
+        return throwError(env, "Failed to wrap BloomFilter");
+    }
+    return self;
+}
+
+napi_value Init(napi_env env, napi_value exports) {
+    napi_property_descriptor methods[] = {
+        {"check", nullptr, Check, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"doubleCheck", nullptr, DoubleCheck, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"add", nullptr, Add, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"remove", nullptr, Remove, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"checkBatch", nullptr, CheckBatch, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"doubleCheckBatch", nullptr, DoubleCheckBatch, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"addBatch", nullptr, AddBatch, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"removeBatch", nullptr, RemoveBatch, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"reload", nullptr, Reload, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"version", nullptr, Version, nullptr, nullptr, nullptr, napi_default, nullptr},
+    };
+
+    napi_value cls;
+    napi_define_class(env, "BloomFilter", NAPI_AUTO_LENGTH, Construct, nullptr,
+                      sizeof(methods) / sizeof(methods[0]), methods, &cls);
+    napi_set_named_property(env, exports, "BloomFilter", cls);
+    return exports;
+}
+
+} // namespace
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
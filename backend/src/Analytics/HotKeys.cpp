@@ -0,0 +1,220 @@
+#include "HotKeys.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+const size_t SHARDS = 16;
+const size_t DEPTH = 4;                // Sketch rows
+const size_t WIDTH = 2048;             // Counters per row (power of two)
+
+// Count-min sketch with conservative update: only the rows holding the
+// current minimum are raised, which keeps over-estimates down.
+struct Sketch {
+    uint32_t counters[DEPTH][WIDTH] = {};
+
+    static size_t slot(uint64_t hash, size_t row) {
+        // Double hashing: the high half, forced odd, steps through the rows
+        uint64_t step = (hash >> 32) | 1;
+        return static_cast<size_t>(hash + row * step) & (WIDTH - 1);
+    }
+
+    // Adds one occurrence and returns the new estimate
+    uint32_t add(uint64_t hash) {
+        uint32_t* cells[DEPTH];
+        uint32_t least = UINT32_MAX;
+        for (size_t row = 0; row < DEPTH; ++row) {
+            cells[row] = &counters[row][slot(hash, row)];
+            least = std::min(least, *cells[row]);
+        }
+        if (least == UINT32_MAX) return least;  // Saturated
+        for (uint32_t* cell : cells) {
+            if (*cell == least) *cell = least + 1;
+        }
+        return least + 1;
+    }
+
+    uint32_t estimate(uint64_t hash) const {
+        uint32_t least = UINT32_MAX;
+        for (size_t row = 0; row < DEPTH; ++row) least = std::min(least, counters[row][slot(hash, row)]);
+        return least;
+    }
+};
+
+// The TOP_K keys with the highest sketch estimates seen by one shard.
+// A small open-addressed table maps hashes to entries, so finding a tracked
+// key costs a probe or two rather than a scan.
+struct Summary {
+    static const size_t TABLE_SIZE = 4 * HotKeys::TOP_K;   // Power of two, kept at most 1/4 full
+
+    Sketch sketch;
+    uint64_t hashes[HotKeys::TOP_K] = {};
+    uint32_t counts[HotKeys::TOP_K] = {};
+    std::string keys[HotKeys::TOP_K];
+    uint8_t table[TABLE_SIZE] = {};    // Entry index + 1, or 0 for an empty slot
+    size_t size = 0;
+    uint32_t floor = 0;                // At most the smallest tracked count once full
+
+    void insert(size_t entry) {
+        size_t slot = hashes[entry] & (TABLE_SIZE - 1);
+        while (table[slot]) slot = (slot + 1) & (TABLE_SIZE - 1);
+        table[slot] = static_cast<uint8_t>(entry + 1);
+    }
+
+    void add(std::string_view key, uint64_t hash) {
+        uint32_t count = sketch.add(hash);
+        if (size == HotKeys::TOP_K && count <= floor) return;  // The common case for cold keys
+
+        for (size_t slot = hash & (TABLE_SIZE - 1); table[slot]; slot = (slot + 1) & (TABLE_SIZE - 1)) {
+            size_t i = table[slot] - 1;
+            if (hashes[i] == hash && keys[i] == key) {
+                counts[i] = count;
+                return;
+            }
+        }
+
+        size_t entry;
+        bool replacing = size == HotKeys::TOP_K;
+        if (!replacing) {
+            entry = size++;
+        } else {
+            entry = std::min_element(counts, counts + size) - counts;
+            if (count <= counts[entry]) {
+                floor = counts[entry];
+                return;
+            }
+        }
+
+        // Take the place of the least frequent key; assign() reuses the string's buffer
+        hashes[entry] = hash;
+        counts[entry] = count;
+        keys[entry].assign(key.data(), key.size());
+
+        if (replacing) {
+            // Linear probing can't simply drop one key, so rebuild the table
+            std::fill(table, table + TABLE_SIZE, 0);
+            for (size_t i = 0; i < size; ++i) insert(i);
+            floor = *std::min_element(counts, counts + size);
+        } else {
+            insert(entry);
+        }
+    }
+};
+
+struct alignas(64) Shard {
+    std::mutex mutex;
+    Summary streams[HotKeys::STREAM_COUNT];
+};
+
+Shard shards[SHARDS];
+std::atomic<size_t> nextShard{0};
+std::atomic<bool> recording{true};
+
+// Threads take shards in turn, so concurrent connections rarely share one
+Shard& threadShard() {
+    thread_local Shard& shard = shards[nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS];
+    return shard;
+}
+
+const char* const STREAM_NAMES[HotKeys::STREAM_COUNT] = {"urls", "domains", "false_positives", "spam_domains"};
+
+} // namespace
+
+HotKeys::HotKeys() {}
+
+HotKeys& HotKeys::instance() {
+    static HotKeys hotKeys;
+    return hotKeys;
+}
+
+void HotKeys::record(Stream stream, std::string_view key) {
+    if (!recording.load(std::memory_order_relaxed) || key.empty()) return;
+    uint64_t hash = std::hash<std::string_view>()(key);
+
+    Shard& shard = threadShard();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.streams[stream].add(key, hash);
+}
+
+void HotKeys::recordGet(std::string_view url, bool falsePositive) {
+    if (!recording.load(std::memory_order_relaxed) || url.empty()) return;
+    char buffer[256];
+    std::string_view domain = domainOf(url, buffer);
+    uint64_t urlHash = std::hash<std::string_view>()(url);
+    uint64_t domainHash = std::hash<std::string_view>()(domain);
+
+    // Hash before taking the lock, and take it once for all three streams
+    Shard& shard = threadShard();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.streams[URLS].add(url, urlHash);
+    if (!domain.empty()) shard.streams[DOMAINS].add(domain, domainHash);
+    if (falsePositive) shard.streams[FALSE_POSITIVES].add(url, urlHash);
+}
+
+void HotKeys::recordPost(std::string_view url) {
+    if (!recording.load(std::memory_order_relaxed)) return;
+    char buffer[256];
+    record(SPAM_DOMAINS, domainOf(url, buffer));
+}
+
+std::vector<std::pair<std::string, uint64_t>> HotKeys::top(Stream stream, size_t count) const {
+    // Every key some shard tracks is a candidate
+    std::unordered_map<std::string, uint64_t> candidates;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const Summary& summary = shard.streams[stream];
+        for (size_t i = 0; i < summary.size; ++i) candidates.emplace(summary.keys[i], 0);
+    }
+
+    // A key's total is the sum of its estimates in every shard's sketch
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const Sketch& sketch = shard.streams[stream].sketch;
+        for (auto& candidate : candidates) {
+            candidate.second += sketch.estimate(std::hash<std::string_view>()(candidate.first));
+        }
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> result(candidates.begin(), candidates.end());
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    if (result.size() > count) result.resize(count);
+    return result;
+}
+
+void HotKeys::setEnabled(bool enabled) {
+    recording.store(enabled, std::memory_order_relaxed);
+}
+
+bool HotKeys::streamByName(const std::string& name, Stream& stream) {
+    for (int i = 0; i < STREAM_COUNT; ++i) {
+        if (name == STREAM_NAMES[i]) {
+            stream = static_cast<Stream>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view HotKeys::domainOf(std::string_view url, char (&buffer)[256]) {
+    size_t scheme = url.compare(0, 8, "https://") == 0 ? 8 : url.compare(0, 7, "http://") == 0 ? 7 : 0;
+    url.remove_prefix(scheme);
+    if (url.compare(0, 4, "www.") == 0) url.remove_prefix(4);
+
+    // memchr finds the path quickly; only the host itself is walked byte by byte
+    const void* slash = std::memchr(url.data(), '/', url.size());
+    size_t end = slash ? static_cast<const char*>(slash) - url.data() : url.size();
+    size_t length = 0;
+    for (; length < end && length < sizeof(buffer); ++length) {
+        char c = url[length];
+        if (c == ':' || c == '?' || c == '#') break;
+        buffer[length] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    return std::string_view(buffer, length);
+}
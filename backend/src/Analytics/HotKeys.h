@@ -0,0 +1,73 @@
+#ifndef HOT_KEYS_H
+#define HOT_KEYS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Heavy-hitter counts of the keys the server sees, reported by TOPK.
+ *
+ * Each stream (queried URLs, queried domains, false positives, POSTed domains)
+ * has a count-min sketch and a top-K summary. The summary only admits a key
+ * once its sketch estimate beats the smallest tracked count, so a stream of
+ * unique URLs costs a few counter increments each and allocates nothing.
+ *
+ * State is split into shards, and every thread updates its own shard under a
+ * lock that is normally uncontended. Sketches are linear, so a query adds up
+ * the shards' estimates for every key any shard tracks. Counts are estimates
+ * that can only be too high, by at most a fraction of the stream's total.
+ * Memory is fixed: about 2 MiB, whatever the traffic.
+ */
+class HotKeys {
+public:
+    enum Stream {
+        URLS,             // URLs asked about by GET
+        DOMAINS,          // Domains of those URLs
+        FALSE_POSITIVES,  // URLs the bit array matched but the blacklist didn't hold
+        SPAM_DOMAINS,     // Domains of URLs added by POST
+        STREAM_COUNT
+    };
+
+    static const size_t TOP_K = 64;  // Keys tracked per stream and shard, and the most TOPK returns
+
+    static HotKeys& instance();
+
+    /**
+     * @brief Counts one occurrence of `key` in `stream` for the calling thread's shard.
+     */
+    void record(Stream stream, std::string_view key);
+
+    // Records a GET: the URL, its domain, and the URL again if it was a false positive
+    void recordGet(std::string_view url, bool falsePositive);
+
+    // Records a POST: the URL's domain
+    void recordPost(std::string_view url);
+
+    /**
+     * @brief The `count` most frequent keys of a stream, most frequent first.
+     *
+     * @return Pairs of key and estimated count.
+     */
+    std::vector<std::pair<std::string, uint64_t>> top(Stream stream, size_t count) const;
+
+    // Turns recording on or off (on by default)
+    void setEnabled(bool enabled);
+
+    // Looks up a stream by its TOPK name ("urls", "domains", "false_positives", "spam_domains")
+    static bool streamByName(const std::string& name, Stream& stream);
+
+    /**
+     * @brief The host part of a URL: without the scheme, "www." or path, lowercased.
+     *
+     * @param buffer Receives the lowercased host; the result points into it.
+     */
+    static std::string_view domainOf(std::string_view url, char (&buffer)[256]);
+
+private:
+    HotKeys();
+};
+
+#endif // HOT_KEYS_H
@@ -1,8 +1,64 @@
 #include "BloomFilter.h"
-#include "HashFunctions.h"
+#include "Trace/Trace.h"     // Span for save()
 #include <fstream>
 #include <sstream>
 #include <iostream>  // for std::cout and std::cerr
+#include <chrono>
+#include <algorithm>
+#include <cstdio>    // for std::rename
+#include <ctime>
+#include <cstdlib>   // for std::strtoull
+#include <cstring>   // for std::memcpy
+#include <fcntl.h>     // for open()
+#include <sys/mman.h>  // for mmap()
+#include <sys/stat.h>  // for fstat(), stat()
+#include <unistd.h>    // for close()
+
+namespace {
+
+// Wall-clock time in whole seconds, the unit of TTLs and expiry times
+uint64_t nowSeconds() {
+    return static_cast<uint64_t>(std::time(nullptr));
+}
+
+// True if every index is set in the given bit array
+bool allSet(const uint64_t* words, const uint64_t* indices, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t index = indices[i];
+        if (!(words[index / 64] & (uint64_t(1) << (index % 64)))) return false;
+    }
+    return true;
+}
+
+// Binary snapshot layout, in native byte order (it is only read back on the same host):
+//   SnapshotHeader, the hash depths as int32 padded to 8 bytes, the bit words,
+//   then for each blacklisted URL: uint64 expiry (0 if permanent), uint32 length, the bytes.
+struct SnapshotHeader {
+    char magic[8];
+    uint64_t bitCount;
+    uint64_t hashCount;
+    uint64_t urlCount;
+    uint64_t version;
+};
+
+const char SNAPSHOT_MAGIC[8] = {'B', 'L', 'M', 'S', 'N', 'A', 'P', '1'};
+
+// "data/filter_data.txt" -> "data/filter_data.snap"
+std::string snapshotPathFor(const std::string& saveFile) {
+    size_t dot = saveFile.rfind('.');
+    size_t slash = saveFile.rfind('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return saveFile + ".snap";
+    return saveFile.substr(0, dot) + ".snap";
+}
+
+// True if file a was modified after file b
+bool newerThan(const struct stat& a, const struct stat& b) {
+    if (a.st_mtim.tv_sec != b.st_mtim.tv_sec) return a.st_mtim.tv_sec > b.st_mtim.tv_sec;
+    return a.st_mtim.tv_nsec > b.st_mtim.tv_nsec;
+}
+
+}
+
 
 /**
  * @brief Constructs a BloomFilter with given size and hash configuration, 
@@ -11,29 +67,241 @@
  * @param size Number of bits in the Bloom filter.
  * @param config Depths of hash functions to be used.
  * @param file Path to file where Bloom filter state is persisted.
+ * @param expiry Settings for URLs that expire.
+ * @param memory Huge page and NUMA settings for the bit arrays and blacklist,
+ *        and optionally an arena shared with other filters.
  */
-BloomFilter::BloomFilter(size_t size, const std::vector<int>& config, const std::string& file)
-    : bitArray(size, false), hashConfig(config), saveFile(file) {
+BloomFilter::BloomFilter(size_t size, const std::vector<int>& config, const std::string& file,
+                         const ExpiryConfig& expiry, const MemoryConfig& memory)
+    : ownArena(memory.arena ? nullptr : new PageArena(memory.hugePages)),
+      arena(memory.arena ? memory.arena : ownArena.get()),
+      bitWords((size + 63) / 64, 0, ArenaAllocator<uint64_t>(arena, &usage.bits)), bitCount(size),
+      hashConfig(config), kernel(FilterKernel::select(config, size, FilterKernel::layoutPreserving(size))),
+      blacklist(ArenaAllocator<UrlString>(arena, &usage.exactSet)), saveFile(file),
+      snapshotFile(snapshotPathFor(file)), dirtyLog(DirtyLog::allocator_type(nullptr, &usage.dirtyLog)),
+      expiryConfig(expiry), timers(nowSeconds()), lastExpiry(nowSeconds()), stableTime(UINT64_MAX) {
+    // Seed the version from the wall clock so a restarted server never reuses
+    // a version number that a client may still hold
+    version = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    logFloor = version;
+
+    if (expiryConfig.generationSeconds == 0) expiryConfig.generationSeconds = 1;
+    if (expiryConfig.generations == 0) expiryConfig.generations = 1;
+    for (size_t i = 0; i < expiryConfig.generations; ++i) {
+        generations.push_back(Generation{WordVector(ArenaAllocator<uint64_t>(arena, &usage.generations)), {}});
+    }
+    baseSlot = lastExpiry / expiryConfig.generationSeconds + 1;
+
     load(); // attempt to load previous state
+
+    // Readers on every node get a local copy of the bit array, placed on that node.
+    // Generations stay single-copy: they only exist while TTLs are in use.
+    if (memory.numaReplicate && PageArena::nodeCount() > 1) {
+        for (int node = 0; node < PageArena::nodeCount(); ++node) {
+            nodeArenas.emplace_back(new PageArena(memory.hugePages, node));
+            replicas.emplace_back(bitWords.begin(), bitWords.end(),
+                                  ArenaAllocator<uint64_t>(nodeArenas.back().get(), &usage.bits));
+        }
+    }
+}
+
+void BloomFilter::syncReplicas() {
+    for (auto& replica : replicas) {
+        std::copy(bitWords.begin(), bitWords.end(), replica.begin());
+    }
+}
+
+const uint64_t* BloomFilter::localWords() const {
+    if (replicas.empty()) return bitWords.data();
+
+    // Looked up once per thread; connection threads are short-lived
+    thread_local int node = PageArena::currentNode();
+    return replicas[static_cast<size_t>(node) < replicas.size() ? node : 0].data();
+}
+
+/**
+ * @brief Records a changed word in the dirty log used by DIFF.
+ *
+ * @param word Index of the word that changed.
+ */
+void BloomFilter::markDirty(size_t word) {
+    dirtyLog.emplace_back(version, word);
+
+    // Keep the log bounded; anything older must be fetched as a full snapshot
+    while (dirtyLog.size() > MAX_DIRTY_LOG) {
+        logFloor = dirtyLog.front().first;
+        dirtyLog.pop_front();
+    }
+}
+
+void BloomFilter::indicesFor(const std::string& url, std::vector<uint64_t>& indices) const {
+    indices.resize(kernel.depths.size());
+    kernel.indices(kernel, url, indices.data());
+}
+
+void BloomFilter::setBits(WordVector& words, const std::vector<uint64_t>& indices) {
+    bool bumped = false;
+
+    for (uint64_t index : indices) {
+        uint64_t mask = uint64_t(1) << (index % 64);
+
+        // Set the corresponding bit in the bit array, logging the word if it changed
+        uint64_t& word = words[index / 64];
+        if (!(word & mask)) {
+            if (!bumped) {
+                ++version;
+                bumped = true;
+            }
+            word |= mask;
+            markDirty(index / 64);
+
+            // Keep every node's copy of the permanent array in step
+            if (&words == &bitWords) {
+                for (auto& replica : replicas) replica[index / 64] |= mask;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sets a URL's bits in the generation covering its expiry time. Expiries
+ *        beyond the last generation go into the last one for now.
+ *
+ * @param url The URL to place.
+ * @param expiry Its expiry time (Unix seconds), after the current time.
+ */
+void BloomFilter::placeInGeneration(const std::string& url, uint64_t expiry) {
+    uint64_t period = expiryConfig.generationSeconds;
+    uint64_t slot = (expiry + period - 1) / period;
+    slot = std::max(slot, baseSlot);
+    slot = std::min(slot, baseSlot + generations.size() - 1);
+
+    Generation& generation = generations[slot % generations.size()];
+    if (generation.words.empty()) generation.words.assign(bitWords.size(), 0);
+
+    std::vector<uint64_t> indices;
+    indicesFor(url, indices);
+    setBits(generation.words, indices);
+    generation.members.insert(url);  // Once, however often the URL is re-added
+    updateStableTime();
+}
+
+/**
+ * @brief Clears the generations whose period ended at or before `now`.
+ *        Members that haven't expired (they were placed early because their
+ *        expiry was beyond the last generation, or were re-added) are placed again.
+ *
+ * @param now Current time (Unix seconds).
+ */
+void BloomFilter::rotate(uint64_t now) {
+    uint64_t newBase = now / expiryConfig.generationSeconds + 1;
+    if (newBase <= baseSlot) return;
+
+    // Each generation is retired at most once, however long we were idle
+    uint64_t retiring = std::min<uint64_t>(newBase - baseSlot, generations.size());
+    std::unordered_set<std::string> survivors;  // A re-added URL may be a member of several retiring generations
+    bool bumped = false;
+
+    for (uint64_t slot = baseSlot; slot < baseSlot + retiring; ++slot) {
+        Generation& generation = generations[slot % generations.size()];
+
+        // Clearing bits changes the merged view, so clients holding a copy must see it in DIFF
+        for (size_t i = 0; i < generation.words.size(); ++i) {
+            if (!generation.words[i]) continue;
+            if (!bumped) {
+                ++version;
+                bumped = true;
+            }
+            markDirty(i);
+        }
+        generation.words.clear();
+        generation.words.shrink_to_fit();
+
+        for (const auto& url : generation.members) {
+            auto it = expiries.find(url);
+            if (it != expiries.end() && it->second > now) survivors.insert(url);
+        }
+        generation.members.clear();
+    }
+    baseSlot = newBase;
+
+    for (const auto& url : survivors) {
+        placeInGeneration(url, expiries[url]);
+    }
+    updateStableTime();
+}
+
+void BloomFilter::updateStableTime() {
+    bool anyBits = std::any_of(generations.begin(), generations.end(),
+                               [](const Generation& generation) { return !generation.words.empty(); });
+    stableTime.store(anyBits ? baseSlot * expiryConfig.generationSeconds : UINT64_MAX, std::memory_order_release);
+}
+
+/**
+ * @brief Drops URLs whose TTL has passed from the blacklist, then rotates
+ *        generations so their bits stop matching.
+ *
+ * @param now Current time (Unix seconds).
+ */
+void BloomFilter::expireAt(uint64_t now) {
+    if (now <= lastExpiry) return;
+    lastExpiry = now;
+
+    std::vector<TimerWheel::Timer> fired;
+    timers.advance(now, fired);
+
+    bool changed = false;
+    for (const auto& timer : fired) {
+        // Each expiring URL's one timer is at its current expiry; anything else is stale
+        auto it = expiries.find(timer.key);
+        if (it == expiries.end() || it->second != timer.deadline) continue;
+        expiries.erase(it);
+        auto listed = blacklist.find(timer.key);
+        if (listed != blacklist.end()) blacklist.erase(listed);
+        changed = true;
+    }
+
+    rotate(now);
+
+    if (changed) save();
+}
+
+void BloomFilter::expire() {
+    expireAt(nowSeconds());
 }
 
 /**
  * @brief Adds a URL to the Bloom filter and stores it in the real blacklist.
+ *        URLs with a TTL go into an aging generation; the rest are permanent.
  *
  * @param url The URL to add.
+ * @param ttl Seconds until the URL expires; 0 uses the configured default TTL.
  */
-void BloomFilter::add(const std::string& url) {
-    // Loop through each configured hash depth
-    for (int depth : hashConfig) {
-        // Compute the hash for this URL at the given depth
-        size_t index = make_hash(url, depth) % bitArray.size();
+void BloomFilter::add(const std::string& url, uint64_t ttl) {
+    uint64_t now = nowSeconds();
+    expireAt(now);
+
+    if (ttl == 0) ttl = expiryConfig.defaultTtl;
 
-        // Set the corresponding bit in the bit array
-        bitArray[index] = true;
+    std::vector<uint64_t> indices;
+    if (ttl == 0) {
+        // A permanent add overrides any earlier TTL
+        if (expiries.erase(url)) timers.cancel(url);
+        indicesFor(url, indices);
+        setBits(bitWords, indices);
+    } else {
+        // The latest TTL wins: the URL's timer moves to it, and a generation
+        // it already belongs to doesn't list it twice
+        uint64_t expiry = now + ttl;
+        expiries[url] = expiry;
+        timers.schedule(url, expiry);
+        placeInGeneration(url, expiry);
     }
 
     // Add the URL to the actual blacklist (used for double-checking)
-    blacklist.insert(url);
+    listUrl(url);
+    if (fpMemo) fpMemo->erase(std::hash<std::string>()(url));  // No longer a false positive
 
     // Save the updated Bloom filter state to disk
     save();
@@ -43,57 +311,128 @@ void BloomFilter::add(const std::string& url) {
  * @brief Checks if the Bloom filter indicates that a URL might be blacklisted.
  *
  * @param url The URL to check.
- * @return true if all relevant bits are set; false otherwise.
+ * @return true if all relevant bits are set in the permanent array or in a
+ *         live generation; false otherwise.
  */
 bool BloomFilter::check(const std::string& url) const {
-    // Loop through each configured hash depth
-    for (int depth : hashConfig) {
-        // Compute the hash for this URL at the given depth
-        size_t index = make_hash(url, depth) % bitArray.size();
+    // No expiring URLs: only the permanent array can match. The kernel is
+    // unrolled for the configured hash count and reduces indices without dividing.
+    if (expiries.empty()) return kernel.contains(kernel, localWords(), url);
 
-        // If any bit is not set, the URL is definitely not in the filter
-        if (!bitArray[index]) return false;
+    // Hash once, then test the permanent array and each generation
+    uint64_t stackIndices[FilterKernel::MAX_K];
+    std::vector<uint64_t> heapIndices;
+    size_t count = kernel.depths.size();
+    uint64_t* indices = stackIndices;
+    if (count > FilterKernel::MAX_K) {
+        heapIndices.resize(count);
+        indices = heapIndices.data();
     }
+    kernel.indices(kernel, url, indices);
 
-    // All bits are set: URL might be in the filter (could be false positive)
-    return true;
+    if (allSet(localWords(), indices, count)) return true;
+    for (const auto& generation : generations) {
+        if (!generation.words.empty() && allSet(generation.words.data(), indices, count)) return true;
+    }
+    return false;
 }
 
 /**
  * @brief Verifies actual presence in the real blacklist (no false positives).
  *
  * @param url The URL to verify.
- * @return true if the URL is definitely blacklisted.
+ * @return true if the URL is definitely blacklisted and hasn't expired.
  */
 bool BloomFilter::doubleCheck(const std::string& url) const {
-    return blacklist.find(url) != blacklist.end();
+    // A URL already found missing skips the tree walk
+    uint64_t hash = fpMemo ? std::hash<std::string>()(url) : 0;
+    if (fpMemo && fpMemo->contains(hash)) return false;
+
+    if (blacklist.find(url) == blacklist.end()) {
+        if (fpMemo) fpMemo->insert(hash);
+        return false;
+    }
+
+    // Between expire() passes an expired URL may still be listed
+    auto it = expiries.find(url);
+    return it == expiries.end() || it->second > nowSeconds();
+}
+
+/**
+ * @brief Lists a URL in the exact blacklist. Its bytes, if they don't fit in
+ *        the string itself, are counted with the set (see Usage).
+ *
+ * @param url The URL to list.
+ */
+void BloomFilter::listUrl(const std::string& url) {
+    auto it = blacklist.lower_bound(url);
+    if (it != blacklist.end() && std::string_view(*it) == url) return;
+    blacklist.emplace_hint(it, url.data(), url.size(), ArenaAllocator<char>(nullptr, &usage.exactSet));
 }
 
 bool BloomFilter::remove(const std::string& url) {
     auto it = blacklist.find(url);
     if (it != blacklist.end()) {
         blacklist.erase(it);
+        if (expiries.erase(url)) timers.cancel(url);
         save();  // save updated list to disk
         return true;
     }
     return false;
 }
 
+/**
+ * @brief Merges the permanent bit array with every live generation.
+ */
+std::vector<uint64_t> BloomFilter::words() const {
+    std::vector<uint64_t> merged(bitWords.begin(), bitWords.end());
+    for (const auto& generation : generations) {
+        for (size_t i = 0; i < generation.words.size(); ++i) {
+            merged[i] |= generation.words[i];
+        }
+    }
+    return merged;
+}
+
+/**
+ * @brief Counts the set bits of the merged view that words() returns, without
+ *        building it when no generation holds bits.
+ */
+size_t BloomFilter::bitsSet() const {
+    bool anyGeneration = std::any_of(generations.begin(), generations.end(),
+                                     [](const Generation& generation) { return !generation.words.empty(); });
+    size_t set = 0;
+    if (!anyGeneration) {
+        for (uint64_t word : bitWords) set += __builtin_popcountll(word);
+        return set;
+    }
+    for (uint64_t word : words()) set += __builtin_popcountll(word);
+    return set;
+}
 
 /**
  * @brief Saves the current state of the Bloom filter to disk, including:
  *        - bit array
  *        - hash configuration
  *        - blacklist
+ *
+ * Only permanent bits are written; expiring URLs are written with their
+ * expiry time and placed in generations again on load.
  */
 void BloomFilter::save() const {
-    std::ofstream out(saveFile);
+    Trace::Scope span(Trace::SAVE, "save");
+
+    // Write to a temporary file and rename it over the real one, so readers
+    // following this file never see a half-written state
+    const std::string tmpFile = saveFile + ".tmp";
+    std::ofstream out(tmpFile);
 
     // Write bit array as a single line of '0' and '1'
-    for (bool bit : bitArray) {
-        out << bit;
+    std::string bits(bitCount, '0');
+    for (size_t i = 0; i < bitCount; ++i) {
+        if (bitWords[i / 64] & (uint64_t(1) << (i % 64))) bits[i] = '1';
     }
-    out << "\n";
+    out << bits << "\n";
 
     // Write hash config (depths) as space-separated integers
     for (int d : hashConfig) {
@@ -101,21 +440,30 @@ void BloomFilter::save() const {
     }
     out << "\n";
 
-    // Write blacklist: one URL per line
+    // Write blacklist: one URL per line, followed by its expiry time if it has one
     for (const auto& url : blacklist) {
-        out << url << "\n";
+        out << url;
+        auto it = expiries.empty() ? expiries.end() : expiries.find(std::string(url.data(), url.size()));
+        if (it != expiries.end()) out << " " << it->second;
+        out << "\n";
     }
 
+    span.setBytes(static_cast<uint32_t>(out.tellp()));
     out.close();
+    std::rename(tmpFile.c_str(), saveFile.c_str());
 }
 
 /**
  * @brief Loads Bloom filter state from disk:
  *        - First line: bit array
  *        - Second line: hash config
- *        - Remaining lines: blacklist entries
+ *        - Remaining lines: blacklist entries, each optionally followed by
+ *          its expiry time; entries that expired meanwhile are skipped
  */
 void BloomFilter::load() {
+    if (fpMemo) fpMemo->clear();  // Remembered answers are only valid for the blacklist they came from
+    if (loadSnapshot()) return;
+
     std::ifstream in(saveFile);
     if (!in) return;
 
@@ -123,8 +471,8 @@ void BloomFilter::load() {
 
     // Load bit array
     if (std::getline(in, line)) {
-        for (size_t i = 0; i < line.size() && i < bitArray.size(); ++i) {
-            bitArray[i] = line[i] == '1';
+        for (size_t i = 0; i < line.size() && i < bitCount; ++i) {
+            if (line[i] == '1') bitWords[i / 64] |= uint64_t(1) << (i % 64);
         }
     }
 
@@ -136,12 +484,203 @@ void BloomFilter::load() {
         while (iss >> val) {
             hashConfig.push_back(val); // fill hashConfig vector
         }
+        kernel = FilterKernel::select(hashConfig, bitCount, FilterKernel::layoutPreserving(bitCount));
     }
 
     // Load blacklist
+    uint64_t now = nowSeconds();
     while (std::getline(in, line)) {
-        blacklist.insert(line); // insert each line as a blacklisted URL
+        // URLs never contain spaces, so a space separates the expiry time
+        size_t space = line.find(' ');
+        if (space == std::string::npos) {
+            listUrl(line); // insert each line as a blacklisted URL
+            continue;
+        }
+
+        std::string url = line.substr(0, space);
+        uint64_t expiry = std::strtoull(line.c_str() + space + 1, nullptr, 10);
+        if (expiry <= now) continue;
+
+        listUrl(url);
+        expiries[url] = expiry;
+        timers.schedule(url, expiry);
+        placeInGeneration(url, expiry);
     }
 
     in.close();
 }
+
+/**
+ * @brief Writes the snapshot to a temporary file and renames it into place.
+ */
+void BloomFilter::saveSnapshot() const {
+    Trace::Scope span(Trace::SAVE, "snapshot");
+
+    const std::string tmpFile = snapshotFile + ".tmp";
+    std::ofstream out(tmpFile, std::ios::binary);
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.bitCount = bitCount;
+    header.hashCount = hashConfig.size();
+    header.urlCount = blacklist.size();
+    header.version = version;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<int32_t> depths(hashConfig.begin(), hashConfig.end());
+    depths.resize((depths.size() + 1) / 2 * 2, 0);
+    out.write(reinterpret_cast<const char*>(depths.data()), depths.size() * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(bitWords.data()), bitWords.size() * sizeof(uint64_t));
+
+    for (const auto& url : blacklist) {
+        auto it = expiries.empty() ? expiries.end() : expiries.find(std::string(url.data(), url.size()));
+        uint64_t expiry = it == expiries.end() ? 0 : it->second;
+        uint32_t length = static_cast<uint32_t>(url.size());
+        out.write(reinterpret_cast<const char*>(&expiry), sizeof(expiry));
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(url.data(), length);
+    }
+
+    span.setBytes(static_cast<uint32_t>(out.tellp()));
+    out.close();
+    std::rename(tmpFile.c_str(), snapshotFile.c_str());
+}
+
+/**
+ * @brief Maps the snapshot and restores the state from it. The whole file is
+ *        validated before anything is changed, so a truncated or foreign
+ *        snapshot leaves the filter empty for the text loader.
+ */
+bool BloomFilter::loadSnapshot() {
+    struct stat snapStat, textStat;
+    if (stat(snapshotFile.c_str(), &snapStat) != 0) return false;
+    if (stat(saveFile.c_str(), &textStat) == 0 && newerThan(textStat, snapStat)) return false;  // Changed since
+
+    int fd = open(snapshotFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    size_t length = static_cast<size_t>(snapStat.st_size);
+    void* map = length >= sizeof(SnapshotHeader) ? mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    madvise(map, length, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(map);
+    const char* end = data + length;
+    SnapshotHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    size_t depthBytes = (header.hashCount + 1) / 2 * 2 * sizeof(int32_t);
+    size_t wordBytes = bitWords.size() * sizeof(uint64_t);
+    bool valid = std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.bitCount == bitCount && header.hashCount > 0 && header.hashCount <= 1024 &&
+                 length - sizeof(header) >= depthBytes + wordBytes;
+
+    // Walk the URL records once to check they all fit before applying anything
+    const char* depths = data + sizeof(header);
+    const char* urls = depths + (valid ? depthBytes + wordBytes : 0);
+    const char* p = urls;
+    for (uint64_t i = 0; valid && i < header.urlCount; ++i) {
+        uint32_t urlLength;
+        if (end - p < 12) { valid = false; break; }
+        std::memcpy(&urlLength, p + 8, sizeof(urlLength));
+        if (static_cast<size_t>(end - p - 12) < urlLength) valid = false;
+        p += 12 + urlLength;
+    }
+    if (!valid) {
+        munmap(map, length);
+        return false;
+    }
+
+    hashConfig.resize(header.hashCount);
+    for (size_t i = 0; i < header.hashCount; ++i) {
+        int32_t depth;
+        std::memcpy(&depth, depths + i * sizeof(int32_t), sizeof(depth));
+        hashConfig[i] = depth;
+    }
+    kernel = FilterKernel::select(hashConfig, bitCount, FilterKernel::layoutPreserving(bitCount));
+    std::memcpy(bitWords.data(), depths + depthBytes, wordBytes);
+
+    // URLs were written in set order, so each insert goes straight to the end
+    uint64_t now = nowSeconds();
+    ArenaAllocator<char> urlBytes(nullptr, &usage.exactSet);
+    p = urls;
+    for (uint64_t i = 0; i < header.urlCount; ++i) {
+        uint64_t expiry;
+        uint32_t urlLength;
+        std::memcpy(&expiry, p, sizeof(expiry));
+        std::memcpy(&urlLength, p + 8, sizeof(urlLength));
+        const char* url = p + 12;
+        p += 12 + urlLength;
+
+        if (expiry != 0 && expiry <= now) continue;
+        if (expiry != 0) {
+            std::string key(url, urlLength);
+            expiries[key] = expiry;
+            timers.schedule(key, expiry);
+            placeInGeneration(key, expiry);
+        }
+        blacklist.emplace_hint(blacklist.end(), url, urlLength, urlBytes);
+    }
+
+    if (header.version >= version) {
+        version = header.version + 1;
+        logFloor = version;
+    }
+
+    munmap(map, length);
+    return true;
+}
+
+// Replaces the memo with an empty one of the given size, or drops it for 0
+void BloomFilter::setFalsePositiveMemo(size_t entries) {
+    fpMemo.reset(entries ? new FalsePositiveMemo(entries) : nullptr);
+}
+
+/**
+ * @brief Resets the bit array and blacklist, then loads the save file again.
+ *        The version is bumped so clients holding a copy resynchronize.
+ */
+void BloomFilter::reload() {
+    std::fill(bitWords.begin(), bitWords.end(), 0);
+    blacklist.clear();
+
+    uint64_t now = nowSeconds();
+    expiries.clear();
+    timers.clear(now);
+    lastExpiry = now;
+    for (auto& generation : generations) {
+        generation.words.clear();
+        generation.members.clear();
+    }
+    baseSlot = now / expiryConfig.generationSeconds + 1;
+
+    load();
+    syncReplicas();
+    updateStableTime();
+
+    ++version;
+    dirtyLog.clear();
+    logFloor = version;
+}
+
+/**
+ * @brief Collects the words that changed after a given version.
+ *
+ * @param since Version the client already holds.
+ * @param changed Output: sorted, de-duplicated word indices.
+ * @return false if the version is older than the dirty log or newer than the
+ *         filter itself (e.g. issued by another process), so a snapshot is needed.
+ */
+bool BloomFilter::changedWordsSince(uint64_t since, std::vector<size_t>& changed) const {
+    changed.clear();
+    if (since < logFloor || since > version) return false;
+
+    // The log is ordered by version, so walk back from the newest entry
+    for (auto it = dirtyLog.rbegin(); it != dirtyLog.rend() && it->first > since; ++it) {
+        changed.push_back(it->second);
+    }
+
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return true;
+}
@@ -5,30 +5,181 @@
 #include <string>
 #include <functional>
 #include <set>
+#include <deque>
+#include <string_view>
+#include <utility>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include "TimerWheel.h"
+#include "FilterKernel.h"
+#include "PageArena.h"
+#include "FalsePositiveMemo.h"
+#include "MemoryCounter.h"
+#include <memory>
+#include <atomic>
+
+/**
+ * @brief Settings for URLs that expire.
+ *
+ * Expiring URLs set their bits in one of a ring of aging generations rather
+ * than in the permanent bit array. Generation g holds URLs expiring within the
+ * g-th period of generationSeconds from now; once that period has passed, the
+ * whole generation is cleared, so expired URLs stop matching and memory stays
+ * bounded. URLs expiring beyond the last generation are placed in it and moved
+ * forward when it is cleared.
+ */
+struct ExpiryConfig {
+    uint64_t defaultTtl = 0;            // Seconds; 0 means URLs POSTed without a TTL never expire
+    uint64_t generationSeconds = 3600;  // Time span covered by each generation
+    size_t generations = 4;             // Number of aging generations
+};
 
 class BloomFilter {
+public:
+    // Memory of the filter's parts, as reported by MEMORY
+    struct Usage {
+        MemoryCounter bits;          // The permanent bit array and its NUMA replicas
+        MemoryCounter generations;   // Bit arrays of the aging generations
+        MemoryCounter exactSet;      // Blacklist set nodes and the URLs' bytes
+        MemoryCounter dirtyLog;      // Word changes kept for DIFF
+    };
+
 private:
-    std::vector<bool> bitArray;  // Bit array representing the Bloom filter
+    // Bit words and set nodes come from the filter's PageArena. The bytes of a
+    // URL too long for the string's inline buffer come from the heap, counted
+    // along with the set's nodes.
+    using WordVector = std::vector<uint64_t, ArenaAllocator<uint64_t>>;
+    using UrlString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+    // Orders listed URLs and lets them be looked up by std::string
+    struct UrlLess {
+        using is_transparent = void;
+        bool operator()(std::string_view a, std::string_view b) const { return a < b; }
+    };
+    using UrlSet = std::set<UrlString, UrlLess, ArenaAllocator<UrlString>>;
+    using DirtyLog = std::deque<std::pair<uint64_t, size_t>, ArenaAllocator<std::pair<uint64_t, size_t>>>;
+
+    // One aging generation: its own bit array and the URLs whose bits it holds
+    struct Generation {
+        WordVector words;                  // Allocated on first use
+        std::unordered_set<std::string> members;  // Re-placed on rotation if they haven't expired yet
+    };
+
+    Usage usage;  // Counted into by the containers below, down to their destruction; declared first
+    std::unique_ptr<PageArena> ownArena;  // Set unless MemoryConfig shares an arena; declared before the containers
+    PageArena* arena;  // Huge-page backed memory for everything below
+    std::vector<std::unique_ptr<PageArena>> nodeArenas;  // One per NUMA node when replicating
+
+    WordVector bitWords;  // Bit array representing the Bloom filter, packed 64 bits per word
+    std::vector<WordVector> replicas;  // Per-node copies of bitWords, read by threads on that node
+    size_t bitCount;  // Number of usable bits in bitWords
     std::vector<int> hashConfig;  // Stores the depth of each hash function
-    std::set<std::string> blacklist;  // Real blacklist for double-checking false positives
+    FilterKernel::Kernel kernel;  // Probe functions specialized for hashConfig and bitCount
+    UrlSet blacklist;  // Real blacklist for double-checking false positives
     std::string saveFile;  // Path to the file where Bloom filter data is saved
+    std::string snapshotFile;  // Binary image of the same state, written on shutdown for a fast start
+
+    std::atomic<uint64_t> version;  // Bumped every time a bit word changes; may be read without the lock
+    DirtyLog dirtyLog;  // (version, word index) of recent word changes
+    uint64_t logFloor;  // Oldest version that dirtyLog can still produce a diff from
+
+    ExpiryConfig expiryConfig;
+    std::vector<Generation> generations;  // Ring: the generation for slot s is generations[s % count]
+    uint64_t baseSlot;  // Oldest live slot; slot s covers expiries in ((s - 1) * period, s * period]
+    std::unordered_map<std::string, uint64_t> expiries;  // URL -> expiry time (Unix seconds) for expiring URLs
+    TimerWheel timers;  // Fires when an expiring URL is due to leave the blacklist
+    uint64_t lastExpiry;  // Time of the last expire() pass
+    std::atomic<uint64_t> stableTime;  // See stableUntil()
+    mutable std::unique_ptr<FalsePositiveMemo> fpMemo;  // Updated by doubleCheck(); null when off
+
+    /**
+     * @brief Computes the bit index of the URL for every hash depth.
+     */
+    void indicesFor(const std::string& url, std::vector<uint64_t>& indices) const;
+
+    /**
+     * @brief Sets the given bits in a bit array, logging changed words for DIFF.
+     */
+    void setBits(WordVector& words, const std::vector<uint64_t>& indices);
+
+    /**
+     * @brief Copies bitWords into every NUMA replica after a bulk change.
+     */
+    void syncReplicas();
+
+    /**
+     * @brief The copy of bitWords on the calling thread's NUMA node.
+     */
+    const uint64_t* localWords() const;
+
+    /**
+     * @brief Sets the URL's bits in the generation that covers its expiry time.
+     */
+    void placeInGeneration(const std::string& url, uint64_t expiry);
+
+    /**
+     * @brief Clears every generation whose period has ended, re-placing members that are still alive.
+     */
+    void rotate(uint64_t now);
+
+    /**
+     * @brief Removes URLs whose timers fired and rotates generations.
+     */
+    void expireAt(uint64_t now);
+
+    /**
+     * @brief Recomputes stableUntil() after generations gain or lose bits.
+     */
+    void updateStableTime();
+
+    /**
+     * @brief Adds a URL to the exact blacklist, unless it is already there.
+     */
+    void listUrl(const std::string& url);
+
+    /**
+     * @brief Records that a bit word changed at the current version, dropping
+     *        the oldest entries once the log is full.
+     *
+     * @param word Index of the word that changed.
+     */
+    void markDirty(size_t word);
+
+    /**
+     * @brief Restores the state from the binary snapshot, if it is at least as
+     *        recent as the save file and was taken with the same filter size.
+     *
+     * @return false if the text save file has to be loaded instead.
+     */
+    bool loadSnapshot();
 
 public:
+    /**
+     * @brief Maximum number of word changes kept for DIFF requests.
+     *        Older clients fall back to a full snapshot.
+     */
+    static const size_t MAX_DIRTY_LOG = 65536;
+
     /**
      * @brief Constructs a BloomFilter with given size, hash config, and file path.
      *
      * @param size Size of the Bloom filter bit array.
      * @param config Vector representing the hash function depths.
      * @param saveFile File path for saving/loading filter state.
+     * @param expiry Settings for URLs that expire.
+     * @param memory Huge page and NUMA settings for the bit arrays and blacklist.
      */
-    BloomFilter(size_t size, const std::vector<int>& config, const std::string& saveFile);
+    BloomFilter(size_t size, const std::vector<int>& config, const std::string& saveFile,
+                const ExpiryConfig& expiry = ExpiryConfig(), const MemoryConfig& memory = MemoryConfig());
 
     /**
      * @brief Adds a URL to the Bloom filter and the actual blacklist.
      *
      * @param url The URL to add to the filter.
+     * @param ttl Seconds until the URL expires; 0 uses the configured default TTL.
      */
-    void add(const std::string& url);
+    void add(const std::string& url, uint64_t ttl = 0);
 
     /**
      * @brief Checks whether a URL might be in the blacklist using the Bloom filter.
@@ -40,7 +191,9 @@ public:
     bool check(const std::string& url) const;
 
     /**
-     * @brief Performs an exact lookup in the actual blacklist.
+     * @brief Performs an exact lookup in the actual blacklist. With the false
+     *        positive memo on, URLs already found missing are answered from
+     *        the memo, and new misses are added to it.
      *
      * @param url The URL to verify.
      * @return true if the URL is really blacklisted, false if it was a false positive.
@@ -49,6 +202,23 @@ public:
 
     bool remove(const std::string& url);
 
+    /**
+     * @brief Turns the false positive memo (see FalsePositiveMemo.h) on with
+     *        room for `entries` URLs, or off with 0. Starts empty.
+     */
+    void setFalsePositiveMemo(size_t entries);
+
+    /**
+     * @brief The false positive memo, for its counters; nullptr when off.
+     */
+    const FalsePositiveMemo* falsePositiveMemo() const { return fpMemo.get(); }
+
+    /**
+     * @brief Removes expired URLs from the blacklist and clears generations whose
+     *        period has ended. Cheap when called more than once per second.
+     */
+    void expire();
+
 
     /**
      * @brief Saves the current bit array, hash configuration, and blacklist to a file.
@@ -56,12 +226,85 @@ public:
     void save() const;
 
     /**
-     * @brief Loads the bit array, hash configuration, and blacklist from the save file.
+     * @brief Writes the whole state as a binary snapshot next to the save file.
+     *        Loading it maps the file and copies the bit array in one pass,
+     *        instead of parsing a character per bit.
+     */
+    void saveSnapshot() const;
+
+    /**
+     * @brief Loads the bit array, hash configuration, and blacklist from the
+     *        snapshot if it is current, otherwise from the save file.
      *        This restores the filter's previous state.
      */
     void load();
-   
 
+    /**
+     * @brief Discards the in-memory state and loads the save file again.
+     *        Used by readers that follow a file written by another process.
+     */
+    void reload();
+
+    /**
+     * @brief Number of bits in the filter.
+     */
+    size_t size() const { return bitCount; }
+
+    /**
+     * @brief Number of URLs in the exact blacklist.
+     */
+    size_t count() const { return blacklist.size(); }
+
+    /**
+     * @brief Number of bits set, in the permanent array or any live generation.
+     *        Counts every word, so it takes a while on large filters.
+     */
+    size_t bitsSet() const;
+
+    /**
+     * @brief Memory held by the bit arrays, the exact set and the dirty log.
+     *        Safe to read without the lock.
+     */
+    const Usage& memoryUsage() const { return usage; }
+
+    /**
+     * @brief Hash depths currently in use.
+     */
+    const std::vector<int>& getHashConfig() const { return hashConfig; }
+
+    /**
+     * @brief Packed bit array, with the live generations merged in; bit i lives
+     *        in word i / 64 at position i % 64.
+     */
+    std::vector<uint64_t> words() const;
+
+    /**
+     * @brief Current bit array version. Versions are seeded from the wall clock,
+     *        so they keep increasing across restarts. Safe to read without the lock.
+     */
+    uint64_t getVersion() const { return version.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Unix time until which expire() can't clear any bits: the end of the
+     *        oldest generation's period if a generation holds bits, otherwise
+     *        UINT64_MAX. Until then only URLs with a TTL can change their answer
+     *        without the version changing. Safe to read without the lock.
+     */
+    uint64_t stableUntil() const { return stableTime.load(std::memory_order_acquire); }
+
+    /**
+     * @brief True if the URL was added with a TTL that hasn't been overridden.
+     */
+    bool hasExpiry(const std::string& url) const { return expiries.count(url) != 0; }
+
+    /**
+     * @brief Collects the indices of words that changed after the given version.
+     *
+     * @param since Version the client already holds.
+     * @param changed Output: sorted, de-duplicated word indices.
+     * @return false if the dirty log no longer covers that version (a full snapshot is needed).
+     */
+    bool changedWordsSince(uint64_t since, std::vector<size_t>& changed) const;
 };
 
 #endif
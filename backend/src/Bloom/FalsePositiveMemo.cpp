@@ -0,0 +1,78 @@
+#include "FalsePositiveMemo.h"
+
+#include <algorithm>   // For std::fill
+
+namespace {
+
+// Tags are never 0, which marks an empty slot
+uint64_t tagOf(uint64_t hash) {
+    return hash | 1;
+}
+
+} // namespace
+
+FalsePositiveMemo::FalsePositiveMemo(size_t capacity)
+    : buckets(ArenaAllocator<Bucket>(nullptr, &usage)), referenced(ArenaAllocator<uint8_t>(nullptr, &usage)) {
+    size_t count = 1;
+    while (count * WAYS < capacity) count *= 2;
+    buckets.resize(count);
+    referenced.resize(count, 0);
+}
+
+// The high bits pick the bucket; the tag compares all of them
+FalsePositiveMemo::Bucket& FalsePositiveMemo::bucketFor(uint64_t hash, size_t& index) {
+    index = (hash >> 32) & (buckets.size() - 1);
+    return buckets[index];
+}
+
+bool FalsePositiveMemo::contains(uint64_t hash) {
+    size_t index;
+    Bucket& bucket = bucketFor(hash, index);
+    uint64_t tag = tagOf(hash);
+    for (size_t way = 0; way < WAYS; ++way) {
+        if (bucket.tags[way] != tag) continue;
+        referenced[index] |= uint8_t(1) << way;
+        ++counters.hits;
+        return true;
+    }
+    return false;
+}
+
+void FalsePositiveMemo::insert(uint64_t hash) {
+    size_t index;
+    Bucket& bucket = bucketFor(hash, index);
+    uint64_t tag = tagOf(hash);
+    ++counters.inserts;
+
+    size_t target = WAYS;
+    for (size_t way = 0; way < WAYS; ++way) {
+        if (bucket.tags[way] == tag) return;
+        if (bucket.tags[way] == 0 && target == WAYS) target = way;
+    }
+
+    // Full: evict the first slot not hit since the last eviction, then start a new round
+    if (target == WAYS) {
+        uint8_t cold = static_cast<uint8_t>(~referenced[index]);
+        target = cold ? __builtin_ctz(cold) : 0;
+        referenced[index] = 0;
+        ++counters.evictions;
+    }
+    bucket.tags[target] = tag;
+    referenced[index] &= static_cast<uint8_t>(~(1u << target));
+}
+
+void FalsePositiveMemo::erase(uint64_t hash) {
+    size_t index;
+    Bucket& bucket = bucketFor(hash, index);
+    uint64_t tag = tagOf(hash);
+    for (size_t way = 0; way < WAYS; ++way) {
+        if (bucket.tags[way] != tag) continue;
+        bucket.tags[way] = 0;
+        ++counters.invalidations;
+    }
+}
+
+void FalsePositiveMemo::clear() {
+    std::fill(buckets.begin(), buckets.end(), Bucket());
+    std::fill(referenced.begin(), referenced.end(), 0);
+}
@@ -0,0 +1,75 @@
+#ifndef FALSE_POSITIVE_MEMO_H
+#define FALSE_POSITIVE_MEMO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PageArena.h"   // Counting allocator for the buckets
+
+/**
+ * @brief Remembers URLs that the bit array matched but the exact blacklist
+ *        didn't hold, so that asking about them again skips the blacklist.
+ *
+ * A popular clean URL whose bits happen to be set would otherwise pay the
+ * blacklist's tree walk on every GET. Entries are 64-bit URL hashes in
+ * 64-byte buckets of WAYS slots; a full bucket evicts a slot that wasn't hit
+ * since the bucket's last eviction (not-recently-used), so the URLs that keep
+ * coming back stay while one-off false positives cycle out.
+ *
+ * An entry only says "this URL is not blacklisted", which stays true until
+ * the URL itself is added, so the owner erases the URL's hash on every add
+ * and clears the memo when the blacklist is replaced. Changes to other URLs
+ * or to the bits don't matter. Two URLs sharing a hash would share the answer;
+ * with 64-bit hashes that is as unlikely as in the verdict cache.
+ *
+ * Not thread-safe: the owning filter is used under the filter lock.
+ */
+class FalsePositiveMemo {
+public:
+    static const size_t WAYS = 8;   // Slots per bucket: one cache line
+
+    struct Stats {
+        uint64_t hits = 0;            // Blacklist lookups skipped
+        uint64_t inserts = 0;         // False positives that went to the blacklist and were remembered
+        uint64_t invalidations = 0;   // Entries dropped because their URL was added
+        uint64_t evictions = 0;       // Entries pushed out to make room
+    };
+
+    /**
+     * @param capacity Number of entries, rounded up to a power of two buckets.
+     */
+    explicit FalsePositiveMemo(size_t capacity);
+
+    // True if the URL with this hash is a remembered false positive
+    bool contains(uint64_t hash);
+
+    // Remembers a confirmed false positive
+    void insert(uint64_t hash);
+
+    // Forgets a URL that is being added to the blacklist
+    void erase(uint64_t hash);
+
+    // Forgets everything, e.g. when the blacklist is reloaded
+    void clear();
+
+    size_t capacity() const { return buckets.size() * WAYS; }
+
+    const Stats& stats() const { return counters; }
+
+    // Memory held by the buckets
+    const MemoryCounter& memoryUsage() const { return usage; }
+
+private:
+    struct alignas(64) Bucket {
+        uint64_t tags[WAYS] = {};     // Hash | 1 (0: empty)
+    };
+
+    MemoryCounter usage;              // Counted into by the vectors below; declared before them
+    std::vector<Bucket, ArenaAllocator<Bucket>> buckets;
+    std::vector<uint8_t, ArenaAllocator<uint8_t>> referenced;  // Per bucket: a bit per slot hit since the last eviction
+    Stats counters;
+
+    Bucket& bucketFor(uint64_t hash, size_t& index);
+};
+
+#endif // FALSE_POSITIVE_MEMO_H
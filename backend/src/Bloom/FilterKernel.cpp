@@ -0,0 +1,53 @@
+#include "FilterKernel.h"
+
+namespace FilterKernel {
+
+namespace {
+
+// Probe functions for one (K, reduction) pair
+struct Entry {
+    void (*indices)(const Kernel&, const std::string&, uint64_t*);
+    bool (*contains)(const Kernel&, const uint64_t*, const std::string&);
+};
+
+template <class Reduce, size_t... K>
+constexpr std::array<Entry, sizeof...(K)> makeRow(std::index_sequence<K...>) {
+    return {{ Entry{&Fixed<K, Reduce>::indices, &Fixed<K, Reduce>::contains}... }};
+}
+
+// Dispatch table: one row per reduction, one column per hash count 0..MAX_K,
+// every entry instantiated at compile time
+const std::array<Entry, MAX_K + 1> TABLE[] = {
+    makeRow<ModuloReduce>(std::make_index_sequence<MAX_K + 1>()),
+    makeRow<MaskReduce>(std::make_index_sequence<MAX_K + 1>()),
+    makeRow<FastRangeReduce>(std::make_index_sequence<MAX_K + 1>()),
+};
+
+// Runtime-loop fallback for each reduction
+const Entry GENERIC[] = {
+    {&Generic<ModuloReduce>::indices, &Generic<ModuloReduce>::contains},
+    {&Generic<MaskReduce>::indices, &Generic<MaskReduce>::contains},
+    {&Generic<FastRangeReduce>::indices, &Generic<FastRangeReduce>::contains},
+};
+
+} // namespace
+
+Kernel select(const std::vector<int>& depths, uint64_t bitCount, Reduction reduction) {
+    Kernel kernel{depths, bitCount, reduction,
+                  ModuloReduce(bitCount), MaskReduce(bitCount), FastRangeReduce(bitCount),
+                  nullptr, nullptr};
+    std::sort(kernel.depths.begin(), kernel.depths.end());
+
+    size_t row = static_cast<size_t>(reduction);
+    const Entry& entry = depths.size() <= MAX_K ? TABLE[row][depths.size()] : GENERIC[row];
+    kernel.indices = entry.indices;
+    kernel.contains = entry.contains;
+    return kernel;
+}
+
+Reduction layoutPreserving(uint64_t bitCount) {
+    bool powerOfTwo = bitCount && !(bitCount & (bitCount - 1));
+    return powerOfTwo ? Reduction::MASK : Reduction::MODULO;
+}
+
+} // namespace FilterKernel
@@ -0,0 +1,201 @@
+#ifndef FILTER_KERNEL_H
+#define FILTER_KERNEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <array>
+
+/**
+ * @brief Probe kernels for the Bloom filter, specialized at compile time.
+ *
+ * A kernel turns a URL into its bit indices and tests them against the packed
+ * bit array. It is a template over:
+ *  - K, the number of hash functions, so the probe loop is fully unrolled;
+ *  - the hash function (ChainHash: the repo's make_hash, evaluated incrementally);
+ *  - the index reduction (ModuloReduce, MaskReduce or FastRangeReduce);
+ *  - the bit layout (PackedLayout: 64 bits per word, bit i in word i / 64).
+ *
+ * select() picks an instance from a dispatch table built once per filter
+ * configuration; hash counts above MAX_K use a runtime loop.
+ */
+namespace FilterKernel {
+
+    const size_t MAX_K = 16;  // Largest hash count with a specialized kernel
+
+    // How a 64-bit hash is mapped to a bit index in [0, bitCount)
+    enum class Reduction {
+        MODULO,     // hash % bitCount, the filter's on-disk layout
+        MASK,       // hash & (bitCount - 1); equals MODULO when bitCount is a power of two
+        FAST_RANGE  // (hash * bitCount) >> 64; fastest, but maps hashes to other bits than MODULO
+    };
+
+    /**
+     * @brief Exact hash % n without a division (Lemire's fastmod): one 128-bit
+     *        multiply by a precomputed inverse and one high-half multiply.
+     */
+    struct ModuloReduce {
+        uint64_t n;
+        __uint128_t inverse;  // ceil(2^128 / n)
+
+        explicit ModuloReduce(uint64_t n) : n(n), inverse(n ? ~__uint128_t(0) / n + 1 : 0) {}
+
+        uint64_t operator()(uint64_t hash) const {
+            __uint128_t low = inverse * hash;
+            __uint128_t bottom = ((low & UINT64_MAX) * n) >> 64;
+            __uint128_t top = (low >> 64) * n;
+            return static_cast<uint64_t>((bottom + top) >> 64);
+        }
+    };
+
+    // hash & (n - 1), for power-of-two sizes
+    struct MaskReduce {
+        uint64_t mask;
+
+        explicit MaskReduce(uint64_t n) : mask(n - 1) {}
+
+        uint64_t operator()(uint64_t hash) const { return hash & mask; }
+    };
+
+    // Multiply-shift range reduction: uses the high bits of the hash
+    struct FastRangeReduce {
+        uint64_t n;
+
+        explicit FastRangeReduce(uint64_t n) : n(n) {}
+
+        uint64_t operator()(uint64_t hash) const {
+            return static_cast<uint64_t>((__uint128_t(hash) * n) >> 64);
+        }
+    };
+
+    /**
+     * @brief make_hash(url, depth) for ascending depths, sharing the work:
+     *        depth d + 1 hashes the decimal string of depth d's hash, so
+     *        walking the chain once yields every configured depth.
+     */
+    class ChainHash {
+    public:
+        explicit ChainHash(const std::string& url) : value(hasher(url)), depth(1) {}
+
+        // Hash at the given depth; depths must be requested in ascending order
+        uint64_t at(int target) {
+            while (depth < target) {
+                value = hasher(std::to_string(value));
+                ++depth;
+            }
+            return value;
+        }
+
+    private:
+        std::hash<std::string> hasher;
+        size_t value;
+        int depth;
+    };
+
+    // Packed bit array: bit i lives in word i / 64 at position i % 64
+    struct PackedLayout {
+        static bool test(const uint64_t* words, uint64_t index) {
+            return words[index / 64] & (uint64_t(1) << (index % 64));
+        }
+    };
+
+    /**
+     * @brief A filter configuration bound to its specialized probe functions.
+     *        Depths are sorted: the set of probed bits doesn't depend on their order.
+     */
+    struct Kernel {
+        std::vector<int> depths;  // Sorted hash depths
+        uint64_t bitCount;
+        Reduction reduction;
+
+        // Reducers for bitCount, precomputed so probes never divide
+        ModuloReduce modulo;
+        MaskReduce mask;
+        FastRangeReduce fastRange;
+
+        // Writes the URL's depths.size() bit indices to out
+        void (*indices)(const Kernel& kernel, const std::string& url, uint64_t* out);
+
+        // True if every bit of the URL is set in words
+        bool (*contains)(const Kernel& kernel, const uint64_t* words, const std::string& url);
+    };
+
+    // The kernel's precomputed reducer of the given type
+    template <class Reduce> const Reduce& reducer(const Kernel& kernel);
+    template <> inline const ModuloReduce& reducer(const Kernel& kernel) { return kernel.modulo; }
+    template <> inline const MaskReduce& reducer(const Kernel& kernel) { return kernel.mask; }
+    template <> inline const FastRangeReduce& reducer(const Kernel& kernel) { return kernel.fastRange; }
+
+    // Specialized for K hashes: the loops are unrolled over an index sequence
+    template <size_t K, class Reduce, class Hash = ChainHash, class Layout = PackedLayout>
+    struct Fixed {
+        template <size_t... I>
+        static void indicesImpl(const Kernel& kernel, const std::string& url, uint64_t* out,
+                                std::index_sequence<I...>) {
+            const Reduce& reduce = reducer<Reduce>(kernel);
+            Hash hash(url);
+            const int* depths = kernel.depths.data();
+            ((out[I] = reduce(hash.at(depths[I]))), ...);
+        }
+
+        static void indices(const Kernel& kernel, const std::string& url, uint64_t* out) {
+            indicesImpl(kernel, url, out, std::make_index_sequence<K>());
+        }
+
+        static bool contains(const Kernel& kernel, const uint64_t* words, const std::string& url) {
+            // Hash everything first so the K loads are independent of each other
+            uint64_t index[K > 0 ? K : 1];
+            indices(kernel, url, index);
+            return containsImpl(words, index, std::make_index_sequence<K>());
+        }
+
+        // With K = 0 (never selected: the parser rejects an empty depth list) the fold reads nothing
+        template <size_t... I>
+        static bool containsImpl([[maybe_unused]] const uint64_t* words, const uint64_t* index,
+                                 std::index_sequence<I...>) {
+            return (Layout::test(words, index[I]) && ...);
+        }
+    };
+
+    // Any number of hashes, for configurations beyond MAX_K
+    template <class Reduce, class Hash = ChainHash, class Layout = PackedLayout>
+    struct Generic {
+        static void indices(const Kernel& kernel, const std::string& url, uint64_t* out) {
+            const Reduce& reduce = reducer<Reduce>(kernel);
+            Hash hash(url);
+            for (size_t i = 0; i < kernel.depths.size(); ++i) {
+                out[i] = reduce(hash.at(kernel.depths[i]));
+            }
+        }
+
+        static bool contains(const Kernel& kernel, const uint64_t* words, const std::string& url) {
+            const Reduce& reduce = reducer<Reduce>(kernel);
+            Hash hash(url);
+            for (int depth : kernel.depths) {
+                if (!Layout::test(words, reduce(hash.at(depth)))) return false;
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Builds the kernel for a filter configuration from the dispatch table.
+     *
+     * @param depths Hash depths, in any order.
+     * @param bitCount Number of bits in the filter.
+     * @param reduction Index reduction; MASK requires a power-of-two bitCount.
+     */
+    Kernel select(const std::vector<int>& depths, uint64_t bitCount, Reduction reduction);
+
+    /**
+     * @brief The reduction that keeps the filter's "% bitCount" bit layout:
+     *        MASK for power-of-two sizes, MODULO otherwise.
+     */
+    Reduction layoutPreserving(uint64_t bitCount);
+}
+
+#endif // FILTER_KERNEL_H
@@ -69,10 +69,55 @@ bool parseCommandLine(const std::string& line, std::string& command, std::string
  * @return true if the URL matches expected web format
  */
 bool isValidUrl(const std::string& url) {
-    const std::regex urlCheck(R"(^((https?:\/\/)?(www\.)?([a-zA-Z0-9-]+\.)+[a-zA-Z0-9]{2,})(\/\S+)?$)");
+    // Compiled once: building a std::regex costs far more than matching with it
+    static const std::regex urlCheck(R"(^((https?:\/\/)?(www\.)?([a-zA-Z0-9-]+\.)+[a-zA-Z0-9]{2,})(\/\S+)?$)");
     return std::regex_match(url, urlCheck);  // Check if URL matches the pattern
 }
 
+/**
+ * Checks if a string is a valid filter version (unsigned 64-bit decimal number)
+ *
+ * @param version  The version string to check
+ * @return true if the version is valid
+ */
+bool isValidVersion(const std::string& version) {
+    if (version.empty() || version.size() > 20 || !std::all_of(version.begin(), version.end(), ::isdigit))
+        return false;
+    try {
+        std::stoull(version);  // Rejects values above 2^64 - 1
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Checks if a TTL is a positive number of seconds that fits in 32 bits
+ *
+ * @param ttl  The input TTL string
+ * @return true if the TTL is valid
+ */
+bool isValidTtl(const std::string& ttl) {
+    if (ttl.empty() || ttl.size() > 10 || !std::all_of(ttl.begin(), ttl.end(), ::isdigit))
+        return false;
+    uint64_t value = std::stoull(ttl);
+    return value > 0 && value <= UINT32_MAX;
+}
+
+/**
+ * Checks if a namespace name is valid (see InputValidator.h)
+ *
+ * @param name  The namespace name to check
+ * @return true if the name is valid
+ */
+bool isValidNamespace(const std::string& name) {
+    if (name.empty() || name.size() > 32 || !std::islower(static_cast<unsigned char>(name[0]))) return false;
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return std::islower(static_cast<unsigned char>(c)) || std::isdigit(static_cast<unsigned char>(c)) ||
+               c == '-' || c == '_';
+    });
+}
+
 /**
  * Checks if an IP address is valid (IPv4 format: X.X.X.X)
  *
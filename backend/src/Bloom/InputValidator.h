@@ -42,6 +42,34 @@ bool parseCommandLine(const std::string& input, std::string& command, std::strin
  */
 bool isValidUrl(const std::string& url);
 
+/**
+ * Checks if a string is a filter version as returned by SNAPSHOT/DIFF:
+ * a non-empty run of decimal digits that fits in 64 bits.
+ *
+ * @param version  The version string to check
+ * @return true if it is a valid version number
+ */
+bool isValidVersion(const std::string& version);
+
+/**
+ * Checks if a string is a TTL in seconds as accepted by POST:
+ * a positive decimal number that fits in 32 bits.
+ *
+ * @param ttl  The TTL string to check
+ * @return true if it is a valid TTL
+ */
+bool isValidTtl(const std::string& ttl);
+
+/**
+ * Checks if a string is a namespace name as accepted by CREATE:
+ * 1 to 32 lowercase letters, digits, '-' or '_', starting with a letter.
+ * Names never contain a dot, so they can't be mistaken for a URL.
+ *
+ * @param name  The namespace name to check
+ * @return true if it is a valid namespace name
+ */
+bool isValidNamespace(const std::string& name);
+
 /**
  * Checks if the given string is a valid IPv4 address in the form X.X.X.X
  * Each X must be between 0 and 255.
@@ -0,0 +1,94 @@
+#ifndef MEMORY_COUNTER_H
+#define MEMORY_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Live bytes and allocations of one component of the server's memory
+ *        (a filter's bit array, its exact set, a cache, connection buffers...),
+ *        reported by the MEMORY command.
+ *
+ * Kept up to date by the allocator that serves the component (ArenaAllocator
+ * takes a counter), or by a Holding for buffers that don't go through one.
+ * Bytes are as requested, before the arena's or malloc's rounding. Counters
+ * are relaxed atomics, so they can be read at any time; figures read together
+ * may be a few allocations apart.
+ */
+struct MemoryCounter {
+    std::atomic<int64_t> bytes{0};         // Live bytes
+    std::atomic<int64_t> blocks{0};        // Live allocations
+    std::atomic<uint64_t> allocations{0};  // Allocations ever made
+
+    // A copy of the counters, which can be added up across components
+    struct Snapshot {
+        int64_t bytes = 0;
+        int64_t blocks = 0;
+        uint64_t allocations = 0;
+
+        Snapshot& operator+=(const Snapshot& other) {
+            bytes += other.bytes;
+            blocks += other.blocks;
+            allocations += other.allocations;
+            return *this;
+        }
+
+        // "<name>_bytes", "<name>_blocks" and "<name>_allocations" lines, joined by '\n'
+        std::string format(const std::string& name) const {
+            return name + "_bytes " + std::to_string(bytes) + "\n" + name + "_blocks " + std::to_string(blocks) +
+                   "\n" + name + "_allocations " + std::to_string(allocations);
+        }
+    };
+
+    void allocated(size_t n) {
+        bytes.fetch_add(static_cast<int64_t>(n), std::memory_order_relaxed);
+        blocks.fetch_add(1, std::memory_order_relaxed);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void freed(size_t n) {
+        bytes.fetch_sub(static_cast<int64_t>(n), std::memory_order_relaxed);
+        blocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot copy;
+        copy.bytes = bytes.load(std::memory_order_relaxed);
+        copy.blocks = blocks.load(std::memory_order_relaxed);
+        copy.allocations = allocations.load(std::memory_order_relaxed);
+        return copy;
+    }
+
+    /**
+     * @brief Accounts for buffers that don't go through an allocator taking a
+     *        counter, such as a connection's std::strings: the owner calls
+     *        update() with their current total as they grow and shrink, and
+     *        the bytes are given back when the Holding goes away. Counts as one
+     *        block while it holds any bytes. Used by one thread at a time.
+     */
+    class Holding {
+    public:
+        explicit Holding(MemoryCounter& counter) : counter(counter) {}
+        ~Holding() { update(0); }
+
+        Holding(const Holding&) = delete;
+        Holding& operator=(const Holding&) = delete;
+
+        void update(size_t total) {
+            if (total == held) return;
+            if (held == 0) counter.allocated(total);
+            else if (total == 0) counter.freed(held);
+            else counter.bytes.fetch_add(static_cast<int64_t>(total) - static_cast<int64_t>(held),
+                                         std::memory_order_relaxed);
+            held = total;
+        }
+
+    private:
+        MemoryCounter& counter;
+        size_t held = 0;
+    };
+};
+
+#endif // MEMORY_COUNTER_H
@@ -0,0 +1,202 @@
+#include "Namespaces.h"
+
+#include <algorithm>   // For std::sort, std::max_element
+#include <cmath>       // For std::pow
+#include <cstdio>      // For std::rename, std::remove, std::snprintf
+#include <fstream>
+#include <sstream>
+
+const char* const Namespaces::DEFAULT = "default";
+
+void Namespaces::Namespace::recordGet(bool positive, bool blacklisted) {
+    counters.gets.fetch_add(1, std::memory_order_relaxed);
+    if (positive) counters.positives.fetch_add(1, std::memory_order_relaxed);
+    if (positive && !blacklisted) counters.falsePositives.fetch_add(1, std::memory_order_relaxed);
+}
+
+Namespaces::Namespaces(size_t size, const std::vector<int>& depths, const std::string& dataDir,
+                       const ExpiryConfig& expiry, const MemoryConfig& memory, size_t cacheEntries,
+                       size_t fpMemoEntries, size_t maxCreateSize, int maxCreateDepth)
+    : dataDir(dataDir), expiry(expiry), memory(memory), cacheEntries(cacheEntries), fpMemoEntries(fpMemoEntries),
+      maxCreateSize(maxCreateSize), maxCreateDepth(maxCreateDepth), arena(new PageArena(memory.hugePages)) {
+    this->memory.arena = arena.get();
+    defaultNamespace = open(DEFAULT, size, depths);
+
+    // Manifest lines: "<name> <size> <depth> <depth> ..."
+    std::ifstream in(dataDir + "/namespaces.txt");
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        std::string name;
+        size_t nsSize;
+        std::vector<int> nsDepths;
+        int depth;
+        if (!(iss >> name >> nsSize)) continue;
+        while (iss >> depth) nsDepths.push_back(depth);
+        if (nsSize == 0 || nsDepths.empty() || find(name) || count.load() >= MAX_NAMESPACES) continue;
+        open(name, nsSize, nsDepths);
+    }
+}
+
+std::string Namespaces::saveFileFor(const std::string& name) const {
+    if (name == DEFAULT) return dataDir + "/filter_data.txt";
+    return dataDir + "/filter_data." + name + ".txt";
+}
+
+Namespaces::Namespace* Namespaces::open(const std::string& name, size_t size, const std::vector<int>& depths) {
+    std::unique_ptr<Namespace> ns(new Namespace);
+    ns->name = name;
+    ns->filter.reset(new BloomFilter(size, depths, saveFileFor(name), expiry, memory));
+    ns->filter->setFalsePositiveMemo(fpMemoEntries);
+    if (cacheEntries > 0) ns->cache.reset(new VerdictCache(cacheEntries));
+
+    // Fully built before find() can see it
+    size_t index = count.load(std::memory_order_relaxed);
+    slots[index] = std::move(ns);
+    count.store(index + 1, std::memory_order_release);
+    return slots[index].get();
+}
+
+Namespaces::Namespace* Namespaces::find(const std::string& name) {
+    if (name.empty()) return defaultNamespace;
+    size_t published = count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < published; ++i) {
+        if (slots[i]->name == name) return slots[i].get();
+    }
+    return nullptr;
+}
+
+Namespaces::CreateResult Namespaces::create(const std::string& name, size_t size, const std::vector<int>& depths) {
+    if (find(name)) return CreateResult::EXISTS;
+    if (maxCreateSize > 0 && size > maxCreateSize) return CreateResult::TOO_LARGE;
+    if (maxCreateDepth > 0 && *std::max_element(depths.begin(), depths.end()) > maxCreateDepth) {
+        return CreateResult::TOO_LARGE;
+    }
+    if (count.load() >= MAX_NAMESPACES) return CreateResult::FULL;
+
+    // Files of a namespace that is no longer in the manifest must not leak into the new one
+    std::string saveFile = saveFileFor(name);
+    std::remove(saveFile.c_str());
+    std::remove((saveFile.substr(0, saveFile.size() - 4) + ".snap").c_str());
+
+    open(name, size, depths);
+    saveManifest();
+    return CreateResult::CREATED;
+}
+
+void Namespaces::saveManifest() const {
+    const std::string file = dataDir + "/namespaces.txt";
+    const std::string tmpFile = file + ".tmp";
+    {
+        std::ofstream out(tmpFile);
+        if (!out) return;
+        for (size_t i = 1; i < count.load(); ++i) {  // The default namespace is sized by the command line
+            const BloomFilter& filter = *slots[i]->filter;
+            out << slots[i]->name << " " << filter.size();
+            for (int depth : filter.getHashConfig()) out << " " << depth;
+            out << "\n";
+        }
+    }
+    std::rename(tmpFile.c_str(), file.c_str());
+}
+
+void Namespaces::saveSnapshots() const {
+    for (size_t i = 0; i < count.load(); ++i) slots[i]->filter->saveSnapshot();
+}
+
+std::vector<const Namespaces::Namespace*> Namespaces::sortedByName() const {
+    std::vector<const Namespace*> sorted;
+    for (size_t i = 0; i < count.load(); ++i) sorted.push_back(slots[i].get());
+    std::sort(sorted.begin(), sorted.end(), [](const Namespace* a, const Namespace* b) { return a->name < b->name; });
+    return sorted;
+}
+
+std::string Namespaces::format() const {
+    std::string out;
+    for (const Namespace* nsp : sortedByName()) {
+        const Namespace& ns = *nsp;
+        std::string depths;
+        for (int depth : ns.filter->getHashConfig()) depths += (depths.empty() ? "" : ",") + std::to_string(depth);
+
+        if (!out.empty()) out += "\n";
+        out += ns.name + " bits " + std::to_string(ns.filter->size()) + " depths " + depths +
+               " urls " + std::to_string(ns.filter->count()) +
+               " gets " + std::to_string(ns.counters.gets.load()) +
+               " positives " + std::to_string(ns.counters.positives.load()) +
+               " false_positives " + std::to_string(ns.counters.falsePositives.load()) +
+               " posts " + std::to_string(ns.counters.posts.load()) +
+               " deletes " + std::to_string(ns.counters.deletes.load());
+        if (ns.cache) {
+            VerdictCache::Stats cache = ns.cache->stats();
+            out += " cache_entries " + std::to_string(ns.cache->capacity()) +
+                   " cache_hits " + std::to_string(cache.hits) +
+                   " cache_misses " + std::to_string(cache.misses) +
+                   " cache_invalidations " + std::to_string(cache.invalidations) +
+                   " cache_evictions " + std::to_string(cache.evictions);
+        }
+        if (const FalsePositiveMemo* memo = ns.filter->falsePositiveMemo()) {
+            // Hit rate: the share of false positives answered without the blacklist
+            const FalsePositiveMemo::Stats& stats = memo->stats();
+            uint64_t falsePositives = stats.hits + stats.inserts;
+            char rate[16];
+            std::snprintf(rate, sizeof(rate), "%.3f", falsePositives ? double(stats.hits) / falsePositives : 0.0);
+            out += " fp_memo_entries " + std::to_string(memo->capacity()) +
+                   " fp_memo_hits " + std::to_string(stats.hits) +
+                   " fp_memo_hit_rate " + rate +
+                   " fp_memo_invalidations " + std::to_string(stats.invalidations) +
+                   " fp_memo_evictions " + std::to_string(stats.evictions);
+        }
+    }
+    return out;
+}
+
+std::string Namespaces::formatMemory() const {
+    MemoryCounter::Snapshot bits, generations, exactSet, dirtyLog, cache, fpMemo;  // Over every namespace
+    std::string out;
+    for (const Namespace* nsp : sortedByName()) {
+        const BloomFilter& filter = *nsp->filter;
+        const BloomFilter::Usage& usage = filter.memoryUsage();
+        MemoryCounter::Snapshot nsBits = usage.bits.snapshot();
+        MemoryCounter::Snapshot nsGenerations = usage.generations.snapshot();
+        MemoryCounter::Snapshot nsExactSet = usage.exactSet.snapshot();
+        MemoryCounter::Snapshot nsDirtyLog = usage.dirtyLog.snapshot();
+        MemoryCounter::Snapshot nsCache, nsFpMemo;
+        if (nsp->cache) nsCache = nsp->cache->memoryUsage().snapshot();
+        if (const FalsePositiveMemo* memo = filter.falsePositiveMemo()) nsFpMemo = memo->memoryUsage().snapshot();
+
+        // Each hash probe lands on a set bit with probability fill, independently enough for an estimate
+        double fill = double(filter.bitsSet()) / double(filter.size());
+        double fpRate = std::pow(fill, double(filter.getHashConfig().size()));
+        double perUrl = filter.count() ? double(nsBits.bytes + nsGenerations.bytes + nsExactSet.bytes) / filter.count()
+                                       : 0.0;
+        char figures[96];
+        std::snprintf(figures, sizeof(figures), " fill_ratio %.4f fp_rate_estimate %.3g", fill, fpRate);
+        char perUrlText[32];
+        std::snprintf(perUrlText, sizeof(perUrlText), "%.1f", perUrl);
+
+        if (!out.empty()) out += "\n";
+        out += nsp->name + " bits " + std::to_string(filter.size()) + " urls " + std::to_string(filter.count()) +
+               figures +
+               " bit_array_bytes " + std::to_string(nsBits.bytes) +
+               " generation_bytes " + std::to_string(nsGenerations.bytes) +
+               " exact_set_bytes " + std::to_string(nsExactSet.bytes) +
+               " dirty_log_bytes " + std::to_string(nsDirtyLog.bytes) +
+               " cache_bytes " + std::to_string(nsCache.bytes) +
+               " fp_memo_bytes " + std::to_string(nsFpMemo.bytes) +
+               " bytes_per_url " + perUrlText;
+
+        bits += nsBits;
+        generations += nsGenerations;
+        exactSet += nsExactSet;
+        dirtyLog += nsDirtyLog;
+        cache += nsCache;
+        fpMemo += nsFpMemo;
+    }
+
+    out += "\n" + bits.format("bit_array") + "\n" + generations.format("generations") + "\n" +
+           exactSet.format("exact_set") + "\n" + dirtyLog.format("dirty_log") + "\n" +
+           cache.format("verdict_cache") + "\n" + fpMemo.format("fp_memo") +
+           "\narena_mapped_bytes " + std::to_string(arena->mappedBytes()) +
+           "\narena_used_bytes " + std::to_string(arena->usedBytes());
+    return out;
+}
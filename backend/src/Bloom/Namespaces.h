@@ -0,0 +1,149 @@
+#ifndef NAMESPACES_H
+#define NAMESPACES_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BloomFilter.h"
+#include "PageArena.h"
+#include "VerdictCache.h"
+
+/**
+ * @brief Named, independently sized filters served by one process.
+ *
+ * The "default" namespace is the filter given on the command line, saved in
+ * data/filter_data.txt as before. CREATE adds others, each with its own size,
+ * hash depths and save file (data/filter_data.<name>.txt); the list of
+ * namespaces is kept in data/namespaces.txt so they come back on restart.
+ * Every filter allocates from one shared PageArena.
+ *
+ * Callers hold the filter mutex, which guards every namespace (and therefore
+ * the shared arena) at once. The exceptions are find(), the counters and the
+ * verdict caches, which GETs answered from the cache use without the lock.
+ */
+class Namespaces {
+public:
+    static const char* const DEFAULT;          // Name of the command-line filter
+    static const size_t MAX_NAMESPACES = 64;   // Including the default one
+
+    // Per-namespace request counters, reported by NAMESPACES
+    struct Counters {
+        std::atomic<uint64_t> gets{0};
+        std::atomic<uint64_t> positives{0};        // GETs the filter matched
+        std::atomic<uint64_t> falsePositives{0};   // ... that the exact blacklist then rejected
+        std::atomic<uint64_t> posts{0};
+        std::atomic<uint64_t> deletes{0};
+    };
+
+    struct Namespace {
+        std::string name;
+        std::unique_ptr<BloomFilter> filter;
+        std::unique_ptr<VerdictCache> cache;       // Null when caching is off
+        Counters counters;
+
+        // Counts one GET from its verdict
+        void recordGet(bool positive, bool blacklisted);
+    };
+
+    enum class CreateResult { CREATED, EXISTS, FULL, TOO_LARGE };
+
+    /**
+     * @brief Opens the default namespace and every namespace listed in the
+     *        manifest, each loading its saved state.
+     *
+     * @param size Bit count of the default namespace.
+     * @param depths Hash depths of the default namespace.
+     * @param dataDir Directory of the save files and the manifest.
+     * @param expiry TTL settings, shared by every namespace.
+     * @param memory Huge page and NUMA settings for the shared arena and the filters.
+     * @param cacheEntries Size of each namespace's verdict cache; 0 turns caching off.
+     * @param fpMemoEntries Size of each filter's false positive memo; 0 turns it off.
+     * @param maxCreateSize Largest bit count create() accepts; 0 means no limit.
+     * @param maxCreateDepth Largest hash depth create() accepts; 0 means no limit.
+     */
+    Namespaces(size_t size, const std::vector<int>& depths, const std::string& dataDir,
+               const ExpiryConfig& expiry = ExpiryConfig(), const MemoryConfig& memory = MemoryConfig(),
+               size_t cacheEntries = 0, size_t fpMemoEntries = 0, size_t maxCreateSize = 0,
+               int maxCreateDepth = 0);
+
+    Namespaces(const Namespaces&) = delete;
+    Namespaces& operator=(const Namespaces&) = delete;
+
+    /**
+     * @brief Looks up a namespace; an empty name means the default one.
+     *        Safe without the lock: namespaces are only ever added.
+     * @return nullptr if there is no such namespace.
+     */
+    Namespace* find(const std::string& name);
+
+    /**
+     * @brief The default namespace. Never changes, so it may be read without the lock.
+     */
+    Namespace* primary() const { return defaultNamespace; }
+
+    /**
+     * @brief Creates an empty namespace and records it in the manifest.
+     *        Save files left behind under the same name are discarded.
+     *        A size or depth over the limits is refused, since the filter is
+     *        allocated and every request hashed under the lock.
+     */
+    CreateResult create(const std::string& name, size_t size, const std::vector<int>& depths);
+
+    /**
+     * @brief Writes a binary snapshot of every namespace (see BloomFilter::saveSnapshot()).
+     */
+    void saveSnapshots() const;
+
+    /**
+     * @brief One line per namespace, in name order: sizing, URL count and counters,
+     *        including the verdict cache's and the false positive memo's.
+     */
+    std::string format() const;
+
+    /**
+     * @brief Memory report, for MEMORY. One line per namespace, in name order:
+     *        the share of bits set, the false positive rate that implies,
+     *        the bytes held by each part of the filter, and bytes per URL
+     *        (bit arrays and exact set over the URL count; the caches and the
+     *        dirty log are bounded whatever the count, so they are left out).
+     *        Then "name value" lines adding up each part over every namespace,
+     *        and the shared arena's mapped and used bytes. Reads every bit,
+     *        so callers hold the lock.
+     */
+    std::string formatMemory() const;
+
+    /**
+     * @brief Bytes currently mapped by the shared arena.
+     */
+    size_t mappedBytes() const { return arena->mappedBytes(); }
+
+private:
+    std::string dataDir;
+    ExpiryConfig expiry;
+    MemoryConfig memory;
+    size_t cacheEntries;
+    size_t fpMemoEntries;
+    size_t maxCreateSize;
+    int maxCreateDepth;
+    std::unique_ptr<PageArena> arena;          // Outlives every filter below
+
+    // Filled in creation order and never shrunk; `count` publishes new entries to find()
+    std::unique_ptr<Namespace> slots[MAX_NAMESPACES];
+    std::atomic<size_t> count{0};
+    Namespace* defaultNamespace;
+
+    // Every namespace, in name order
+    std::vector<const Namespace*> sortedByName() const;
+
+    // Save file of a namespace; the default one keeps the original name
+    std::string saveFileFor(const std::string& name) const;
+
+    Namespace* open(const std::string& name, size_t size, const std::vector<int>& depths);
+
+    // Rewrites the manifest with every namespace but the default one
+    void saveManifest() const;
+};
+
+#endif // NAMESPACES_H
@@ -0,0 +1,129 @@
+#include "PageArena.h"
+
+#include <sys/mman.h>          // For mmap(), madvise(), munmap()
+#include <sys/syscall.h>       // For SYS_mbind, SYS_getcpu
+#include <unistd.h>            // For syscall()
+#include <fstream>
+#include <string>
+
+namespace {
+
+const size_t PAGE_SIZE = 4096;
+const size_t HUGE_PAGE_SIZE = 2 << 20;
+const int MPOL_BIND_MODE = 2;  // MPOL_BIND from <linux/mempolicy.h>, without linking libnuma
+
+size_t roundUp(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+} // namespace
+
+PageArena::PageArena(HugePages hugePages, int node)
+    : policy(hugePages), boundNode(node), fallback(false), mapped(0), used(0),
+      slabCursor(nullptr), slabLeft(0) {}
+
+PageArena::~PageArena() {
+    for (const auto& region : regions) munmap(region.first, region.second);
+    for (const auto& slab : slabs) munmap(slab.first, slab.second);
+}
+
+// Maps a fresh region of at least `bytes`, applying the huge page and NUMA policy
+// before anything touches it. Throws std::bad_alloc when the kernel refuses.
+void* PageArena::map(size_t bytes, size_t& length) {
+    void* p = MAP_FAILED;
+
+    if (policy == HugePages::HUGETLB) {
+        length = roundUp(bytes, HUGE_PAGE_SIZE);
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) fallback = true;  // No reserved huge pages: use THP instead
+    }
+
+    if (p == MAP_FAILED) {
+        length = roundUp(bytes, policy == HugePages::OFF ? PAGE_SIZE : HUGE_PAGE_SIZE);
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        if (policy != HugePages::OFF) madvise(p, length, MADV_HUGEPAGE);
+    }
+
+    // Pages are placed on first touch, so binding now keeps the whole region on the node
+    if (boundNode >= 0 && boundNode < 64) {
+        unsigned long nodemask = 1UL << boundNode;
+        syscall(SYS_mbind, p, length, MPOL_BIND_MODE, &nodemask, sizeof(nodemask) * 8 + 1, 0);
+    }
+
+    mapped += length;
+    return p;
+}
+
+void* PageArena::allocate(size_t bytes) {
+    if (bytes == 0) bytes = 1;
+
+    if (bytes > SMALL_LIMIT) {
+        size_t length;
+        void* p = map(bytes, length);
+        regions.emplace(p, length);
+        used += length;
+        return p;
+    }
+
+    size_t cls = (bytes - 1) / SIZE_CLASS;
+    size_t size = (cls + 1) * SIZE_CLASS;
+    used += size;
+    auto& freeList = freeLists[cls];
+    if (!freeList.empty()) {
+        void* p = freeList.back();
+        freeList.pop_back();
+        return p;
+    }
+
+    if (slabLeft < size) {
+        size_t length;
+        slabCursor = static_cast<char*>(map(SLAB_SIZE, length));
+        slabLeft = length;
+        slabs.emplace_back(slabCursor, length);
+    }
+    void* p = slabCursor;
+    slabCursor += size;
+    slabLeft -= size;
+    return p;
+}
+
+void PageArena::deallocate(void* p, size_t bytes) {
+    if (!p) return;
+    if (bytes == 0) bytes = 1;
+
+    if (bytes > SMALL_LIMIT) {
+        auto it = regions.find(p);
+        if (it == regions.end()) return;
+        munmap(it->first, it->second);
+        mapped -= it->second;
+        used -= it->second;
+        regions.erase(it);
+        return;
+    }
+
+    // Small blocks are reused by later allocations of the same class; slabs stay mapped
+    size_t cls = (bytes - 1) / SIZE_CLASS;
+    used -= (cls + 1) * SIZE_CLASS;
+    freeLists[cls].push_back(p);
+}
+
+int PageArena::nodeCount() {
+    // Format: ranges such as "0" or "0-1"; the last number is the highest node
+    std::ifstream in("/sys/devices/system/node/online");
+    std::string online;
+    if (!(in >> online) || online.empty()) return 1;
+    size_t start = online.find_last_of("-,");
+    start = start == std::string::npos ? 0 : start + 1;
+    try {
+        return std::stoi(online.substr(start)) + 1;
+    } catch (...) {
+        return 1;
+    }
+}
+
+int PageArena::currentNode() {
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+    return static_cast<int>(node);
+}
@@ -0,0 +1,149 @@
+#ifndef PAGE_ARENA_H
+#define PAGE_ARENA_H
+
+#include "MemoryCounter.h"   // Per-component accounting done by ArenaAllocator
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// How the arena asks the kernel for huge pages
+enum class HugePages {
+    OFF,      // Regular 4 KiB pages
+    THP,      // Transparent huge pages via madvise(MADV_HUGEPAGE)
+    HUGETLB   // Reserved huge pages via MAP_HUGETLB; falls back to THP if none are free
+};
+
+class PageArena;
+
+// Memory settings for a filter's bit arrays and exact set
+struct MemoryConfig {
+    HugePages hugePages = HugePages::OFF;
+    bool numaReplicate = false;  // Keep a copy of the bit array on every NUMA node
+    PageArena* arena = nullptr;  // Arena shared with other filters; the filter makes its own if null
+};
+
+/**
+ * @brief Memory source for the filter's large arrays and set nodes.
+ *
+ * Large blocks get their own mmap'd region, with huge pages if configured and,
+ * optionally, bound to one NUMA node before first touch. Small blocks (set
+ * nodes, bucket-sized allocations) are carved from 2 MiB slabs mapped the same
+ * way, with a free list per 16-byte size class, so they share huge pages too.
+ *
+ * Not thread-safe: the owner serializes allocations, as BloomFilter's callers
+ * already do for writes.
+ */
+class PageArena {
+public:
+    /**
+     * @param hugePages Huge page policy for every region.
+     * @param node NUMA node to bind regions to, or -1 for the default policy.
+     */
+    explicit PageArena(HugePages hugePages = HugePages::OFF, int node = -1);
+    ~PageArena();
+
+    PageArena(const PageArena&) = delete;
+    PageArena& operator=(const PageArena&) = delete;
+
+    void* allocate(size_t bytes);
+    void deallocate(void* p, size_t bytes);
+
+    HugePages hugePages() const { return policy; }
+    int node() const { return boundNode; }
+
+    // True if any region had to fall back from HUGETLB to THP
+    bool fellBack() const { return fallback; }
+
+    // Bytes currently mapped, including slabs
+    size_t mappedBytes() const { return mapped; }
+
+    // Bytes currently handed out, rounded up to size classes and whole regions.
+    // The rest of mappedBytes() sits in free lists or the current slab's tail.
+    size_t usedBytes() const { return used; }
+
+    // Number of NUMA nodes the kernel reports online (1 without NUMA)
+    static int nodeCount();
+
+    // NUMA node of the CPU the calling thread is running on
+    static int currentNode();
+
+private:
+    static const size_t SLAB_SIZE = 2 << 20;      // One huge page
+    static const size_t SMALL_LIMIT = 512;        // Larger blocks get their own region
+    static const size_t SIZE_CLASS = 16;
+
+    HugePages policy;
+    int boundNode;
+    bool fallback;
+    size_t mapped;
+    size_t used;
+
+    std::unordered_map<void*, size_t> regions;    // Large block -> mapped length
+    std::vector<std::pair<void*, size_t>> slabs;
+    char* slabCursor;
+    size_t slabLeft;
+    std::vector<void*> freeLists[SMALL_LIMIT / SIZE_CLASS];
+
+    void* map(size_t bytes, size_t& length);
+};
+
+/**
+ * @brief Standard allocator over a PageArena, for the filter's containers.
+ *        A null arena allocates with operator new. With a counter, every
+ *        allocation is also recorded there (see MemoryCounter.h), so the
+ *        containers of one component can be accounted for together.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    // Containers keep their arena when assigned or swapped
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(PageArena* arena = nullptr, MemoryCounter* counter = nullptr) noexcept
+        : arena(arena), counter(counter) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena), counter(other.counter) {}
+
+    T* allocate(size_t n) {
+        void* p;
+        if (arena) p = arena->allocate(n * sizeof(T));
+        else if (overAligned) p = ::operator new(n * sizeof(T), std::align_val_t(alignof(T)));
+        else p = ::operator new(n * sizeof(T));
+        if (counter) counter->allocated(n * sizeof(T));
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (counter) counter->freed(n * sizeof(T));
+        if (arena) arena->deallocate(p, n * sizeof(T));
+        else if (overAligned) ::operator delete(p, std::align_val_t(alignof(T)));
+        else ::operator delete(p);
+    }
+
+    // Memory from one allocator can only be returned through one with the same counter
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena == other.arena && counter == other.counter;
+    }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return !(*this == other); }
+
+    PageArena* arena;
+    MemoryCounter* counter;
+
+private:
+    // Plain operator new only guarantees this much; cache-line aligned buckets need more
+    static constexpr bool overAligned = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+};
+
+#endif // PAGE_ARENA_H
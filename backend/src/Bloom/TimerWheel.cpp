@@ -0,0 +1,103 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(uint64_t now) : current(now) {}
+
+// Puts a timer in the finest level whose range covers its deadline.
+// Level L holds deadlines less than 64^(L+1) ticks away, in slots of 64^L ticks.
+void TimerWheel::place(Timer timer) {
+    if (timer.deadline <= current) {
+        locations[timer.key] = Location{LEVELS, 0, overdue.size()};
+        overdue.push_back(std::move(timer));
+        return;
+    }
+
+    uint64_t delta = timer.deadline - current;
+    unsigned level = 0;
+    while (level + 1 < LEVELS && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+
+    // Beyond the top level's range: park it in the farthest top-level slot,
+    // it will be re-placed when that slot cascades
+    uint64_t deadline = timer.deadline;
+    uint64_t horizon = uint64_t(1) << (SLOT_BITS * LEVELS);
+    if (delta >= horizon) deadline = current + horizon - 1;
+
+    unsigned slot = static_cast<unsigned>((deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+    locations[timer.key] = Location{level, slot, slots[level][slot].size()};
+    slots[level][slot].push_back(std::move(timer));
+}
+
+void TimerWheel::unlink(const Location& location) {
+    std::vector<Timer>& timers = location.level == LEVELS ? overdue : slots[location.level][location.slot];
+    if (location.index + 1 != timers.size()) {
+        timers[location.index] = std::move(timers.back());
+        locations[timers[location.index].key].index = location.index;
+    }
+    timers.pop_back();
+}
+
+void TimerWheel::schedule(const std::string& key, uint64_t deadline) {
+    auto it = locations.find(key);
+    if (it != locations.end()) unlink(it->second);
+    place(Timer{key, deadline});
+}
+
+void TimerWheel::cancel(const std::string& key) {
+    auto it = locations.find(key);
+    if (it == locations.end()) return;
+    unlink(it->second);
+    locations.erase(it);
+}
+
+void TimerWheel::fire(std::vector<Timer>& due, std::vector<Timer>& fired) {
+    for (auto& timer : due) {
+        locations.erase(timer.key);
+        fired.push_back(std::move(timer));
+    }
+    due.clear();
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<Timer>& fired) {
+    // Timers that were already due when scheduled
+    fire(overdue, fired);
+
+    // Nothing left to fire: jump straight to `now`
+    if (locations.empty()) {
+        if (now > current) current = now;
+        return;
+    }
+
+    while (current < now) {
+        ++current;
+
+        // When a level wraps, pull the next level's current slot down to finer levels
+        for (unsigned level = 1; level < LEVELS; ++level) {
+            if (current & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) break;
+            unsigned slot = static_cast<unsigned>((current >> (SLOT_BITS * level)) & (SLOTS - 1));
+            std::vector<Timer> cascading;
+            cascading.swap(slots[level][slot]);
+            for (auto& timer : cascading) place(std::move(timer));
+        }
+
+        // Everything now in the finest level's current slot is due
+        fire(slots[0][current & (SLOTS - 1)], fired);
+
+        // Cascading may have found deadlines that are already due
+        fire(overdue, fired);
+
+        if (locations.empty()) {
+            current = now;
+            break;
+        }
+    }
+}
+
+void TimerWheel::clear(uint64_t now) {
+    for (auto& level : slots) {
+        for (auto& slot : level) slot.clear();
+    }
+    overdue.clear();
+    locations.clear();
+    current = now;
+}
@@ -0,0 +1,90 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Hierarchical timer wheel keyed by URL, with one-second ticks.
+ *
+ * Four levels of 64 slots cover about 194 days at increasing granularity;
+ * a timer lands in the finest level that can hold it and is moved down
+ * ("cascaded") as its deadline approaches. Scheduling is O(1), and each timer
+ * is touched at most once per level before it fires, so expiry is O(1) amortized.
+ *
+ * A key has at most one timer: scheduling it again moves the timer to the new
+ * deadline, so re-adding a URL doesn't stack timers. Each timer's position is
+ * indexed by key, which makes rescheduling and cancelling O(1) as well.
+ */
+class TimerWheel {
+public:
+    // A fired timer: the key and the deadline it was scheduled for
+    struct Timer {
+        std::string key;
+        uint64_t deadline;
+    };
+
+    /**
+     * @param now Current time in seconds; the wheel starts ticking from here.
+     */
+    explicit TimerWheel(uint64_t now = 0);
+
+    /**
+     * @brief Schedules a key to fire at the given deadline (seconds), replacing
+     *        its earlier timer if it has one. Deadlines at or before the current
+     *        tick fire on the next advance().
+     */
+    void schedule(const std::string& key, uint64_t deadline);
+
+    /**
+     * @brief Drops the key's timer, if it has one.
+     */
+    void cancel(const std::string& key);
+
+    /**
+     * @brief Moves the wheel forward to `now`, collecting every timer that fired.
+     *
+     * @param now Current time in seconds.
+     * @param fired Output: timers whose deadline is at or before `now`.
+     */
+    void advance(uint64_t now, std::vector<Timer>& fired);
+
+    /**
+     * @brief Drops every timer and restarts the wheel at `now`.
+     */
+    void clear(uint64_t now);
+
+    /**
+     * @brief Number of timers still scheduled.
+     */
+    size_t size() const { return locations.size(); }
+
+private:
+    static const unsigned LEVELS = 4;
+    static const unsigned SLOT_BITS = 6;
+    static const unsigned SLOTS = 1u << SLOT_BITS;
+
+    // Where a key's timer sits: slots[level][slot][index], or overdue[index] when level is LEVELS
+    struct Location {
+        unsigned level;
+        unsigned slot;
+        size_t index;
+    };
+
+    std::vector<Timer> slots[LEVELS][SLOTS];
+    std::vector<Timer> overdue;  // Scheduled at or before the current tick
+    uint64_t current;            // Last processed tick
+    std::unordered_map<std::string, Location> locations;  // Key -> its timer, for every scheduled key
+
+    void place(Timer timer);
+
+    // Takes the timer at `location` out of its slot, keeping the moved-in timer's location right
+    void unlink(const Location& location);
+
+    // Hands every timer in `due` to `fired` and forgets their locations
+    void fire(std::vector<Timer>& due, std::vector<Timer>& fired);
+};
+
+#endif // TIMER_WHEEL_H
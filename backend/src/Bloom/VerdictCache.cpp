@@ -0,0 +1,119 @@
+#include "VerdictCache.h"
+#include "BloomFilter.h"
+
+#include <algorithm>   // For std::max
+#include <ctime>
+#include <functional>  // For std::hash
+
+namespace {
+
+// Never 0, which marks an empty slot
+uint64_t fingerprintOf(const std::string& url) {
+    uint64_t hash = std::hash<std::string>()(url);
+    return hash ? hash : 1;
+}
+
+} // namespace
+
+VerdictCache::VerdictCache(size_t capacity)
+    : bucketsPerShard(std::max<size_t>(1, (capacity + SHARDS * WAYS - 1) / (SHARDS * WAYS))),
+      shards(new Shard[SHARDS]) {
+    for (size_t i = 0; i < SHARDS; ++i) {
+        shards[i].slots = decltype(Shard::slots)(bucketsPerShard * WAYS, Slot(), ArenaAllocator<Slot>(nullptr, &usage));
+        shards[i].hands = decltype(Shard::hands)(bucketsPerShard, 0, ArenaAllocator<uint8_t>(nullptr, &usage));
+    }
+}
+
+// The low bits pick the shard, the rest the bucket, so the two are independent
+VerdictCache::Slot* VerdictCache::bucketFor(uint64_t hash, Shard*& shard) {
+    shard = &shards[hash & (SHARDS - 1)];
+    return &shard->slots[(hash / SHARDS) % bucketsPerShard * WAYS];
+}
+
+bool VerdictCache::lookup(const std::string& url, const BloomFilter& filter, Verdict& verdict) {
+    uint64_t fingerprint = fingerprintOf(url);
+    Shard* shard;
+    Slot* bucket = bucketFor(fingerprint, shard);
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (size_t way = 0; way < WAYS; ++way) {
+        Slot& slot = bucket[way];
+        if (slot.fingerprint != fingerprint) continue;
+
+        // Answers that depend on the bits hold until the bits change or a generation is due to be cleared
+        bool fresh = slot.verdict == BLACKLISTED ||
+                     (slot.version == filter.getVersion() &&
+                      (filter.stableUntil() == UINT64_MAX || uint64_t(std::time(nullptr)) < filter.stableUntil()));
+        if (!fresh) {
+            slot.fingerprint = 0;
+            break;
+        }
+        slot.referenced = true;
+        verdict = slot.verdict;
+        ++shard->stats.hits;
+        return true;
+    }
+    ++shard->stats.misses;
+    return false;
+}
+
+void VerdictCache::insert(const std::string& url, Verdict verdict, const BloomFilter& filter) {
+    // A URL with a TTL stops being blacklisted when it expires, without any write
+    if (verdict == BLACKLISTED && filter.hasExpiry(url)) return;
+
+    uint64_t fingerprint = fingerprintOf(url);
+    Shard* shard;
+    Slot* bucket = bucketFor(fingerprint, shard);
+    uint8_t& hand = shard->hands[(bucket - shard->slots.data()) / WAYS];
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    Slot* target = nullptr;
+    for (size_t way = 0; way < WAYS && !target; ++way) {
+        if (bucket[way].fingerprint == fingerprint) target = &bucket[way];
+    }
+    for (size_t way = 0; way < WAYS && !target; ++way) {
+        if (bucket[way].fingerprint == 0) target = &bucket[way];
+    }
+
+    // CLOCK: clear reference bits until the hand finds a slot that wasn't hit since its last pass
+    while (!target) {
+        Slot& slot = bucket[hand];
+        hand = (hand + 1) % WAYS;
+        if (slot.referenced) {
+            slot.referenced = false;
+        } else {
+            target = &slot;
+            ++shard->stats.evictions;
+        }
+    }
+
+    target->fingerprint = fingerprint;
+    target->version = filter.getVersion();
+    target->verdict = verdict;
+    target->referenced = false;
+}
+
+void VerdictCache::invalidate(const std::string& url) {
+    uint64_t fingerprint = fingerprintOf(url);
+    Shard* shard;
+    Slot* bucket = bucketFor(fingerprint, shard);
+
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (size_t way = 0; way < WAYS; ++way) {
+        if (bucket[way].fingerprint != fingerprint) continue;
+        bucket[way].fingerprint = 0;
+        ++shard->stats.invalidations;
+    }
+}
+
+VerdictCache::Stats VerdictCache::stats() const {
+    Stats total;
+    for (size_t i = 0; i < SHARDS; ++i) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        total.hits += shards[i].stats.hits;
+        total.misses += shards[i].stats.misses;
+        total.invalidations += shards[i].stats.invalidations;
+        total.evictions += shards[i].stats.evictions;
+    }
+    return total;
+}
@@ -0,0 +1,105 @@
+#ifndef VERDICT_CACHE_H
+#define VERDICT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "PageArena.h"   // Counting allocator for the slot tables
+
+class BloomFilter;
+
+/**
+ * @brief Final GET verdicts of recently queried URLs, in front of one filter.
+ *
+ * A hit skips the filter lock, the hash probes and the blacklist lookup. The
+ * cache is split into shards with their own mutex, each a set-associative
+ * table: a URL's fingerprint selects a bucket of WAYS slots, and a full bucket
+ * evicts with CLOCK (a slot hit since the hand last passed gets a second chance).
+ *
+ * Entries stay exact without a flush on every write:
+ *  - "false" and "true false" verdicts record the filter version and are
+ *    dropped once it changes (a POST set new bits or a generation was
+ *    cleared) or once stableUntil() has passed;
+ *  - "true true" verdicts only change when that URL is deleted or re-added,
+ *    so they are never cached for URLs with a TTL, and the filter's owner
+ *    calls invalidate() after a POST or DELETE of the URL.
+ *
+ * URLs are keyed by a 64-bit hash; two URLs sharing one would share a verdict.
+ */
+class VerdictCache {
+public:
+    enum Verdict : uint8_t {
+        ABSENT,           // Not in the Bloom filter
+        FALSE_POSITIVE,   // In the Bloom filter but not blacklisted
+        BLACKLISTED       // In the Bloom filter and blacklisted
+    };
+
+    static const size_t WAYS = 8;       // Slots per bucket
+    static const size_t SHARDS = 16;    // Independently locked parts (power of two)
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;            // Including entries found stale
+        uint64_t invalidations = 0;     // Entries dropped by invalidate()
+        uint64_t evictions = 0;         // Entries pushed out by CLOCK
+    };
+
+    /**
+     * @param capacity Number of entries, rounded up to a whole number of buckets per shard.
+     */
+    explicit VerdictCache(size_t capacity);
+
+    /**
+     * @brief Looks up a URL's verdict. Needs no lock on the filter.
+     * @return false on a miss or a stale entry (which is dropped).
+     */
+    bool lookup(const std::string& url, const BloomFilter& filter, Verdict& verdict);
+
+    /**
+     * @brief Stores the verdict just computed for a URL. The caller holds the
+     *        filter lock, so the verdict matches the filter's current version.
+     */
+    void insert(const std::string& url, Verdict verdict, const BloomFilter& filter);
+
+    /**
+     * @brief Drops a URL's entry after a POST or DELETE of that URL.
+     *        The caller holds the filter lock.
+     */
+    void invalidate(const std::string& url);
+
+    size_t capacity() const { return SHARDS * bucketsPerShard * WAYS; }
+
+    Stats stats() const;
+
+    /**
+     * @brief Memory held by the shards' slot tables. Safe to read at any time.
+     */
+    const MemoryCounter& memoryUsage() const { return usage; }
+
+private:
+    struct Slot {
+        uint64_t fingerprint = 0;       // 0: empty
+        uint64_t version = 0;           // Filter version the verdict was computed at
+        Verdict verdict = ABSENT;
+        bool referenced = false;        // CLOCK bit, set on every hit
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::vector<Slot, ArenaAllocator<Slot>> slots;        // bucketsPerShard * WAYS
+        std::vector<uint8_t, ArenaAllocator<uint8_t>> hands;  // CLOCK hand of each bucket
+        Stats stats;
+    };
+
+    MemoryCounter usage;                // Counted into by the shards' tables; declared before them
+    size_t bucketsPerShard;
+    std::unique_ptr<Shard[]> shards;
+
+    // Finds the shard and the first slot of the URL's bucket
+    Slot* bucketFor(uint64_t hash, Shard*& shard);
+};
+
+#endif // VERDICT_CACHE_H
@@ -0,0 +1,150 @@
+#include "BlacklistClient.h"       // Pooled, pipelined binary client
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Command-line client for scripting against the blacklist server.
+ *
+ * check, add and remove take URLs as arguments, or one per line on standard
+ * input when there are none. They all go out at once through a
+ * BlacklistClient (checks batched), in windows of WINDOW requests, and each
+ * gets one tab-separated line of output in input order:
+ *   check   absent | false_positive | blacklisted
+ *   add     created | rejected
+ *   remove  removed | not_found
+ *   any     error, with the reason after the URL
+ * command sends each argument as a text protocol command (e.g.
+ * "GET mail example.com" for a namespace) and prints the responses.
+ *
+ * Usage: ./blacklist_cli [--host=HOST] [--port=PORT] [--unix=PATH] [--connections=N]
+ *                        [--timeout-ms=MS] [--retries=N] [--ttl=SECONDS]
+ *                        check|add|remove [URL...] | command LINE...
+ * Exits with 1 if any request failed, 2 on bad arguments.
+ */
+namespace {
+
+const size_t WINDOW = 16384;   // Requests in flight while reading standard input
+
+const char* USAGE =
+    "Usage: %s [--host=HOST] [--port=PORT] [--unix=PATH] [--connections=N] [--timeout-ms=MS]\n"
+    "          [--retries=N] [--ttl=SECONDS] check|add|remove [URL...] | command LINE...\n";
+
+bool parseNumber(const std::string& value, long max, long& out) {
+    if (value.empty() || value.size() > 10 || !std::all_of(value.begin(), value.end(), ::isdigit)) return false;
+    out = std::stol(value);
+    return out <= max;
+}
+
+// Parses a "--name=value" argument into the client options or the TTL
+bool parseOption(const std::string& arg, BlacklistClient::Options& options, uint32_t& ttl) {
+    size_t eq = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) return false;
+    std::string name = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+    long number;
+
+    if (name == "host") options.host = value;
+    else if (name == "unix") options.unixPath = value;
+    else if (name == "port" && parseNumber(value, 65535, number) && number > 0) options.port = static_cast<int>(number);
+    else if (name == "connections" && parseNumber(value, 1024, number) && number > 0) options.connections = number;
+    else if (name == "timeout-ms" && parseNumber(value, 3600000, number) && number > 0) {
+        options.timeout = std::chrono::milliseconds(number);
+    } else if (name == "retries" && parseNumber(value, 100, number)) options.retries = static_cast<int>(number);
+    else if (name == "ttl" && parseNumber(value, 0x7FFFFFFF, number)) ttl = static_cast<uint32_t>(number);
+    else return false;
+    return !value.empty();
+}
+
+const char* verdictName(BlacklistClient::Verdict verdict) {
+    switch (verdict) {
+        case BinaryProtocol::VERDICT_BLACKLISTED: return "blacklisted";
+        case BinaryProtocol::VERDICT_FALSE_POSITIVE: return "false_positive";
+        default: return "absent";
+    }
+}
+
+// Sends one window of requests and prints their results in order; returns the failure count
+size_t runWindow(BlacklistClient& client, const std::string& action, const std::vector<std::string>& urls,
+                 uint32_t ttl) {
+    std::vector<std::future<BlacklistClient::Verdict>> checks;
+    std::vector<std::future<bool>> writes;
+    for (const std::string& url : urls) {
+        if (action == "check") checks.push_back(client.check(url));
+        else if (action == "add") writes.push_back(client.add(url, ttl));
+        else writes.push_back(client.remove(url));
+    }
+
+    size_t failures = 0;
+    for (size_t i = 0; i < urls.size(); ++i) {
+        try {
+            const char* result;
+            if (action == "check") result = verdictName(checks[i].get());
+            else if (action == "add") result = writes[i].get() ? "created" : "rejected";
+            else result = writes[i].get() ? "removed" : "not_found";
+            std::printf("%s\t%s\n", result, urls[i].c_str());
+        } catch (const BlacklistClient::Error& error) {
+            std::printf("error\t%s\t%s\n", urls[i].c_str(), error.what());
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BlacklistClient::Options options;
+    uint32_t ttl = 0;
+    int arg = 1;
+    for (; arg < argc && std::string(argv[arg]).compare(0, 2, "--") == 0; ++arg) {
+        if (!parseOption(argv[arg], options, ttl)) {
+            std::fprintf(stderr, "Invalid option %s\n", argv[arg]);
+            std::fprintf(stderr, USAGE, argv[0]);
+            return 2;
+        }
+    }
+    std::string action = arg < argc ? argv[arg++] : "";
+    if (action != "check" && action != "add" && action != "remove" && action != "command") {
+        std::fprintf(stderr, USAGE, argv[0]);
+        return 2;
+    }
+
+    BlacklistClient client(options);
+    size_t failures = 0;
+
+    if (action == "command") {
+        for (; arg < argc; ++arg) {
+            try {
+                std::printf("%s\n", client.command(argv[arg]).c_str());
+            } catch (const BlacklistClient::Error& error) {
+                std::fprintf(stderr, "%s: %s\n", argv[arg], error.what());
+                ++failures;
+            }
+        }
+        return failures ? 1 : 0;
+    }
+
+    std::vector<std::string> urls(argv + arg, argv + argc);
+    if (!urls.empty()) {
+        failures += runWindow(client, action, urls, ttl);
+    } else {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            urls.push_back(line);
+            if (urls.size() == WINDOW) {
+                failures += runWindow(client, action, urls, ttl);
+                urls.clear();
+            }
+        }
+        failures += runWindow(client, action, urls, ttl);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,610 @@
+#include "BlacklistClient.h"
+
+#include <fcntl.h>                  // For fcntl()
+#include <netdb.h>                  // For getaddrinfo()
+#include <netinet/in.h>             // For IPPROTO_TCP
+#include <netinet/tcp.h>            // For TCP_NODELAY
+#include <poll.h>                   // For poll()
+#include <sys/eventfd.h>            // For eventfd()
+#include <sys/socket.h>             // For socket(), connect(), send(), recv()
+#include <sys/time.h>               // For timeval
+#include <sys/un.h>                 // For sockaddr_un
+#include <unistd.h>                 // For close(), read(), write()
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <thread>
+
+namespace {
+
+// Connects a socket, giving up after timeoutMs; leaves it blocking
+bool connectWithin(int fd, const sockaddr* addr, socklen_t addrLen, int timeoutMs, std::string& error) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int result = connect(fd, addr, addrLen);
+    if (result != 0 && errno == EINPROGRESS) {
+        pollfd pending{fd, POLLOUT, 0};
+        if (poll(&pending, 1, timeoutMs) == 1) {
+            int soError = 0;
+            socklen_t length = sizeof(soError);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &soError, &length);
+            errno = soError;
+            result = soError ? -1 : 0;
+        } else {
+            errno = ETIMEDOUT;
+        }
+    }
+    if (result != 0) {
+        error = std::string("connect: ") + std::strerror(errno);
+        return false;
+    }
+    fcntl(fd, F_SETFL, flags);
+    return true;
+}
+
+int millisecondsUntil(BlacklistClient::Clock::time_point deadline) {
+    auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - BlacklistClient::Clock::now()).count();
+    return static_cast<int>(std::max<decltype(left)>(left, 0));
+}
+
+BlacklistClient::Error errorFor(const BlacklistClient::Reply& reply) {
+    if (!reply.ok) return BlacklistClient::Error(reply.error);
+    return BlacklistClient::Error("server answered status " + std::to_string(reply.status));
+}
+
+} // namespace
+
+struct BlacklistClient::Connection {
+    int fd = -1;
+    int wakeFd = -1;                    // eventfd that interrupts poll() when requests are queued
+    std::atomic<bool> idle{false};      // In poll() with room for more requests
+    std::thread thread;
+    std::string out;                    // Frames not yet written, from outPos on
+    size_t outPos = 0;
+    std::string in;                     // Response bytes not yet parsed
+    std::map<uint32_t, Frame> inFlight;
+    size_t inFlightRequests = 0;
+    Clock::time_point lastProgress;     // Last response, or when requests became outstanding
+    uint32_t nextId = 1;                // 0 is what the server answers a malformed frame with
+    std::string lastError;
+};
+
+BlacklistClient::BlacklistClient() : BlacklistClient(Options()) {}
+
+BlacklistClient::BlacklistClient(const Options& options) : options(options) {
+    this->options.connections = std::max<size_t>(this->options.connections, 1);
+    this->options.maxBatch = std::max<size_t>(this->options.maxBatch, 1);
+    this->options.maxInFlight = std::max<size_t>(this->options.maxInFlight, 1);
+
+    // Every connection exists before any thread can look for one to wake
+    for (size_t i = 0; i < this->options.connections; ++i) {
+        pool.emplace_back(new Connection);
+        pool.back()->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    for (auto& connection : pool) {
+        Connection* c = connection.get();
+        c->thread = std::thread([this, c]() { run(*c); });
+    }
+}
+
+BlacklistClient::~BlacklistClient() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    for (auto& connection : pool) {
+        uint64_t one = 1;
+        (void)!write(connection->wakeFd, &one, sizeof(one));
+    }
+    for (auto& connection : pool) connection->thread.join();
+
+    std::vector<Request> left(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+    queue.clear();
+    for (auto& connection : pool) {
+        for (auto& entry : connection->inFlight) {
+            for (Request& request : entry.second.requests) left.push_back(std::move(request));
+        }
+        if (connection->fd >= 0) close(connection->fd);
+        close(connection->wakeFd);
+    }
+    fail(left, "client closed");
+}
+
+std::future<BlacklistClient::Verdict> BlacklistClient::check(const std::string& url) {
+    auto promise = std::make_shared<std::promise<Verdict>>();
+    std::future<Verdict> future = promise->get_future();
+    check(url, [promise](const Reply& reply) {
+        if (reply.ok && reply.status == BinaryProtocol::STATUS_OK) promise->set_value(reply.verdict);
+        else promise->set_exception(std::make_exception_ptr(errorFor(reply)));
+    });
+    return future;
+}
+
+std::future<std::vector<BlacklistClient::Verdict>> BlacklistClient::checkAll(const std::vector<std::string>& urls) {
+    struct Pending {
+        std::promise<std::vector<Verdict>> promise;
+        std::vector<Verdict> verdicts;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed{false};
+    };
+    auto pending = std::make_shared<Pending>();
+    pending->verdicts.resize(urls.size());
+    pending->remaining = urls.size();
+    std::future<std::vector<Verdict>> future = pending->promise.get_future();
+    if (urls.empty()) pending->promise.set_value({});
+
+    for (size_t i = 0; i < urls.size(); ++i) {
+        check(urls[i], [pending, i](const Reply& reply) {
+            if (reply.ok && reply.status == BinaryProtocol::STATUS_OK) {
+                pending->verdicts[i] = reply.verdict;
+            } else if (!pending->failed.exchange(true)) {
+                pending->promise.set_exception(std::make_exception_ptr(errorFor(reply)));
+            }
+            // The last reply hands over the verdicts, unless one of them failed
+            if (pending->remaining.fetch_sub(1) == 1 && !pending->failed.load()) {
+                pending->promise.set_value(std::move(pending->verdicts));
+            }
+        });
+    }
+    return future;
+}
+
+std::future<bool> BlacklistClient::add(const std::string& url, uint32_t ttl) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    add(url, ttl, [promise](const Reply& reply) {
+        if (reply.ok && reply.status == BinaryProtocol::STATUS_CREATED) promise->set_value(true);
+        else if (reply.ok && reply.status == BinaryProtocol::STATUS_BAD_REQUEST) promise->set_value(false);
+        else promise->set_exception(std::make_exception_ptr(errorFor(reply)));
+    });
+    return future;
+}
+
+std::future<bool> BlacklistClient::remove(const std::string& url) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    remove(url, [promise](const Reply& reply) {
+        if (reply.ok && reply.status == BinaryProtocol::STATUS_NO_CONTENT) promise->set_value(true);
+        else if (reply.ok && reply.status == BinaryProtocol::STATUS_NOT_FOUND) promise->set_value(false);
+        else promise->set_exception(std::make_exception_ptr(errorFor(reply)));
+    });
+    return future;
+}
+
+void BlacklistClient::check(const std::string& url, Callback callback) {
+    submit(BinaryProtocol::OP_GET, url, 0, std::move(callback));
+}
+
+void BlacklistClient::add(const std::string& url, uint32_t ttl, Callback callback) {
+    submit(BinaryProtocol::OP_POST, url, ttl, std::move(callback));
+}
+
+void BlacklistClient::remove(const std::string& url, Callback callback) {
+    submit(BinaryProtocol::OP_DELETE, url, 0, std::move(callback));
+}
+
+void BlacklistClient::submit(uint8_t op, const std::string& url, uint32_t ttl, Callback callback) {
+    counters.requests.fetch_add(1, std::memory_order_relaxed);
+    std::vector<Request> rejected;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Request request{op, url, ttl, 0, Clock::now(), std::move(callback)};
+        if (stopping) rejected.push_back(std::move(request));
+        else queue.push_back(std::move(request));
+    }
+    if (!rejected.empty()) {
+        fail(rejected, "client closed");
+        return;
+    }
+    wakeIdle();
+}
+
+void BlacklistClient::wakeIdle() {
+    size_t start = nextWake.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < pool.size(); ++i) {
+        Connection& c = *pool[(start + i) % pool.size()];
+        if (c.idle.exchange(false)) {
+            uint64_t one = 1;
+            (void)!write(c.wakeFd, &one, sizeof(one));
+            return;
+        }
+    }
+    // No connection is idle: each busy one looks at the queue before it blocks again
+}
+
+void BlacklistClient::run(Connection& c) {
+    int backoffMs = 50;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+        }
+
+        if (c.fd < 0) {
+            if (!connect(c)) {
+                failStale(c.lastError);
+                pollfd wake{c.wakeFd, POLLIN, 0};
+                poll(&wake, 1, backoffMs);
+                uint64_t drained;
+                (void)!read(c.wakeFd, &drained, sizeof(drained));
+                backoffMs = std::min(backoffMs * 2, 1000);
+                continue;
+            }
+            backoffMs = 50;
+        }
+
+        pickUp(c);
+        if (c.fd < 0) continue;
+
+        // Block until the socket or the queue needs attention, or the connection has been silent too long
+        int waitMs = c.inFlight.empty() ? -1 : millisecondsUntil(c.lastProgress + options.timeout);
+        if (c.inFlightRequests < options.maxInFlight) {
+            c.idle.store(true);
+            // A request queued before idle was set found no one to wake
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!queue.empty() || stopping) waitMs = 0;
+        }
+
+        pollfd fds[2] = {
+            {c.fd, static_cast<short>(POLLIN | (c.outPos < c.out.size() ? POLLOUT : 0)), 0},
+            {c.wakeFd, POLLIN, 0}};
+        int ready = poll(fds, 2, waitMs);
+        c.idle.store(false);
+        if (ready < 0) {
+            if (errno != EINTR) reset(c, std::string("poll: ") + std::strerror(errno));
+            continue;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            uint64_t drained;
+            (void)!read(c.wakeFd, &drained, sizeof(drained));
+        }
+        if (fds[0].revents & POLLOUT) flush(c);
+        if (c.fd >= 0 && (fds[0].revents & (POLLIN | POLLHUP | POLLERR))) readResponses(c);
+
+        if (c.fd >= 0 && !c.inFlight.empty() && Clock::now() >= c.lastProgress + options.timeout) {
+            counters.timeouts.fetch_add(1, std::memory_order_relaxed);
+            reset(c, "no response for " + std::to_string(options.timeout.count()) + " ms");
+        }
+    }
+}
+
+bool BlacklistClient::connect(Connection& c) {
+    int fd = openSocket(static_cast<int>(options.timeout.count()), c.lastError);
+    if (fd < 0) return false;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    c.fd = fd;
+    c.nextId = 1;
+    connected.fetch_add(1);
+    counters.connects.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void BlacklistClient::pickUp(Connection& c) {
+    std::vector<Request> taken;
+    bool more;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t room = options.maxInFlight - std::min(options.maxInFlight, c.inFlightRequests);
+        while (room > 0 && !queue.empty()) {
+            taken.push_back(std::move(queue.front()));
+            queue.pop_front();
+            --room;
+        }
+        more = !queue.empty();
+    }
+    if (more) wakeIdle();
+    if (taken.empty()) return;
+
+    using namespace BinaryProtocol;
+    if (c.inFlight.empty()) c.lastProgress = Clock::now();
+    std::vector<Request> tooLong;
+
+    auto send = [&](uint8_t op, std::vector<Request>& requests, const std::string& payload, uint8_t flags) {
+        uint32_t id = c.nextId++;
+        if (c.nextId == 0) c.nextId = 1;
+        appendFrame(c.out, op, id, payload, flags);
+        counters.frames.fetch_add(1, std::memory_order_relaxed);
+        if (requests.size() > 1) counters.batched.fetch_add(requests.size(), std::memory_order_relaxed);
+        c.inFlightRequests += requests.size();
+        c.inFlight[id] = Frame{op, std::move(requests)};
+    };
+
+    // Consecutive checks share BATCH_GET frames; writes keep their place between them
+    std::vector<Request> batch;
+    std::string batchPayload;
+    auto sendBatch = [&]() {
+        if (batch.empty()) return;
+        if (batch.size() == 1) {
+            std::string url = batch[0].url;
+            send(OP_GET, batch, url, 0);
+        } else {
+            send(OP_BATCH_GET, batch, batchPayload, 0);
+        }
+        batch.clear();
+        batchPayload.clear();
+    };
+
+    for (Request& request : taken) {
+        if (request.url.size() + 4 > MAX_PAYLOAD) {
+            tooLong.push_back(std::move(request));
+            continue;
+        }
+        if (request.op != OP_GET) {
+            sendBatch();
+            std::string payload;
+            uint8_t flags = 0;
+            if (request.op == OP_POST) {
+                appendPost(payload, request.url, request.ttl);
+                if (request.ttl) flags = FLAG_TTL;
+            } else {
+                payload = request.url;
+            }
+            std::vector<Request> single;
+            single.push_back(std::move(request));
+            send(single[0].op, single, payload, flags);
+            continue;
+        }
+        // Batch entries carry a u16 length, and the frame a bounded payload
+        if (request.url.size() > 0xFFFF) {
+            sendBatch();
+            std::vector<Request> single;
+            single.push_back(std::move(request));
+            std::string url = single[0].url;
+            send(OP_GET, single, url, 0);
+            continue;
+        }
+        if (batch.size() == options.maxBatch || batchPayload.size() + 2 + request.url.size() > MAX_PAYLOAD) {
+            sendBatch();
+        }
+        appendBatchUrl(batchPayload, request.url);
+        batch.push_back(std::move(request));
+    }
+    sendBatch();
+
+    fail(tooLong, "URL longer than the largest frame");
+    flush(c);
+}
+
+void BlacklistClient::flush(Connection& c) {
+    while (c.outPos < c.out.size()) {
+        ssize_t n = ::send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, MSG_NOSIGNAL);
+        if (n > 0) {
+            c.outPos += static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            reset(c, std::string("send: ") + std::strerror(errno));
+            return;
+        }
+    }
+    c.out.clear();
+    c.outPos = 0;
+}
+
+void BlacklistClient::readResponses(Connection& c) {
+    char buffer[65536];
+    while (true) {
+        ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            c.in.append(buffer, static_cast<size_t>(n));
+            c.lastProgress = Clock::now();
+            if (static_cast<size_t>(n) < sizeof(buffer)) break;
+        } else if (n == 0) {
+            reset(c, "connection closed by the server");
+            return;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            reset(c, std::string("recv: ") + std::strerror(errno));
+            return;
+        }
+    }
+
+    using namespace BinaryProtocol;
+    size_t pos = 0;
+    while (c.in.size() - pos >= HEADER_SIZE) {
+        Header header;
+        if (!decodeHeader(c.in.data() + pos, header) || header.length > MAX_PAYLOAD) {
+            reset(c, "malformed response frame");
+            return;
+        }
+        if (c.in.size() - pos - HEADER_SIZE < header.length) break;
+
+        auto it = c.inFlight.find(header.requestId);
+        if (it != c.inFlight.end()) {
+            Frame frame = std::move(it->second);
+            c.inFlight.erase(it);
+            c.inFlightRequests -= frame.requests.size();
+            complete(frame, header, c.in.data() + pos + HEADER_SIZE);
+        }
+        pos += HEADER_SIZE + header.length;
+    }
+    c.in.erase(0, pos);
+}
+
+void BlacklistClient::complete(Frame& frame, const BinaryProtocol::Header& header, const char* payload) {
+    using namespace BinaryProtocol;
+    bool verdicts = header.code == STATUS_OK && header.length == frame.requests.size() &&
+                    (frame.op == OP_GET || frame.op == OP_BATCH_GET);
+    for (size_t i = 0; i < frame.requests.size(); ++i) {
+        Reply reply;
+        reply.ok = true;
+        reply.status = static_cast<Status>(header.code);
+        if (verdicts) reply.verdict = static_cast<Verdict>(payload[i]);
+        else if (header.code == STATUS_OK) reply.status = STATUS_BAD_REQUEST;  // A GET answered without its verdicts
+        if (frame.requests[i].callback) frame.requests[i].callback(reply);
+    }
+}
+
+void BlacklistClient::fail(std::vector<Request>& requests, const std::string& error) {
+    Reply reply;
+    reply.error = error;
+    for (Request& request : requests) {
+        if (request.callback) request.callback(reply);
+    }
+}
+
+void BlacklistClient::reset(Connection& c, const std::string& error) {
+    if (c.fd >= 0) {
+        close(c.fd);
+        connected.fetch_sub(1);
+    }
+    c.fd = -1;
+    c.out.clear();
+    c.outPos = 0;
+    c.in.clear();
+
+    std::vector<Request> again, failed;
+    for (auto& entry : c.inFlight) {
+        for (Request& request : entry.second.requests) {
+            if (request.attempts < options.retries) {
+                ++request.attempts;
+                request.queuedAt = Clock::now();
+                again.push_back(std::move(request));
+            } else {
+                failed.push_back(std::move(request));
+            }
+        }
+    }
+    c.inFlight.clear();
+    c.inFlightRequests = 0;
+
+    if (!again.empty()) {
+        counters.retries.fetch_add(again.size(), std::memory_order_relaxed);
+        {
+            // Ahead of newer requests, in their original order
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.insert(queue.begin(), std::make_move_iterator(again.begin()), std::make_move_iterator(again.end()));
+        }
+        wakeIdle();
+    }
+    fail(failed, error);
+}
+
+void BlacklistClient::failStale(const std::string& error) {
+    std::vector<Request> stale;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (connected.load() > 0) return;  // An open connection will get to them
+        Clock::time_point cutoff = Clock::now() - options.timeout;
+        auto keep = std::stable_partition(queue.begin(), queue.end(),
+                                          [cutoff](const Request& request) { return request.queuedAt > cutoff; });
+        stale.assign(std::make_move_iterator(keep), std::make_move_iterator(queue.end()));
+        queue.erase(keep, queue.end());
+    }
+    fail(stale, error);
+}
+
+std::string BlacklistClient::command(const std::string& line) {
+    std::string error;
+    int timeoutMs = static_cast<int>(options.timeout.count());
+    int fd = openSocket(timeoutMs, error);
+    if (fd < 0) throw Error(error);
+
+    timeval timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // The server answers one command per connection and then closes its side
+    std::string request = line + "\n";
+    size_t sent = 0;
+    while (sent < request.size()) {
+        ssize_t n = ::send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            error = std::string("send: ") + std::strerror(errno);
+            close(fd);
+            throw Error(error);
+        }
+        sent += static_cast<size_t>(n);
+    }
+
+    std::string response;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            response.append(buffer, static_cast<size_t>(n));
+        } else if (n == 0) {
+            break;
+        } else if (errno != EINTR) {
+            error = errno == EAGAIN || errno == EWOULDBLOCK ? "timed out after " + std::to_string(timeoutMs) + " ms"
+                                                            : std::string("recv: ") + std::strerror(errno);
+            close(fd);
+            throw Error(error);
+        }
+    }
+    close(fd);
+
+    if (!response.empty() && response.back() == '\n') response.pop_back();
+    return response;
+}
+
+BlacklistClient::Stats BlacklistClient::stats() const {
+    Stats stats;
+    stats.requests = counters.requests.load();
+    stats.frames = counters.frames.load();
+    stats.batched = counters.batched.load();
+    stats.retries = counters.retries.load();
+    stats.timeouts = counters.timeouts.load();
+    stats.connects = counters.connects.load();
+    return stats;
+}
+
+int BlacklistClient::openSocket(int timeoutMs, std::string& error) const {
+    if (!options.unixPath.empty()) {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        if (options.unixPath.size() >= sizeof(addr.sun_path)) {
+            error = "Unix socket path too long";
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, options.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || !connectWithin(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr), timeoutMs, error)) {
+            if (fd >= 0) close(fd);
+            error += " (" + options.unixPath + ")";
+            return -1;
+        }
+        return fd;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    int result = getaddrinfo(options.host.c_str(), std::to_string(options.port).c_str(), &hints, &found);
+    if (result != 0) {
+        error = "resolve " + options.host + ": " + gai_strerror(result);
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* ai = found; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (!connectWithin(fd, ai->ai_addr, ai->ai_addrlen, timeoutMs, error)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    if (fd < 0) {
+        error += " (" + options.host + ":" + std::to_string(options.port) + ")";
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
@@ -0,0 +1,179 @@
+#ifndef BLACKLIST_CLIENT_H
+#define BLACKLIST_CLIENT_H
+
+#include "Server/BinaryProtocol.h"   // Frames, opcodes, statuses and verdicts
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Client for the server's binary protocol, shared by C++ services,
+ *        the benchmarks and blacklist_cli.
+ *
+ * Keeps a pool of persistent connections, each served by one I/O thread.
+ * Calls only queue a request and return a future (or take a callback), so any
+ * number of threads can have requests outstanding at once:
+ *  - Pipelining: a connection sends every request it picks up without waiting
+ *    for earlier answers; responses are matched by request ID.
+ *  - Batching: checks waiting in the queue when a connection picks up work go
+ *    out together in one BATCH_GET frame, up to maxBatch URLs. Nothing is held
+ *    back to fill a batch; batches form while the connections are busy.
+ *  - Timeouts: a connection with requests outstanding that receives nothing
+ *    for `timeout` is taken to be stuck and reopened. A busy server that keeps
+ *    answering isn't timed out, however deep its backlog: resending the
+ *    backlog would only add to it.
+ *  - Retries: requests lost to a broken or stuck connection are sent again,
+ *    up to `retries` more times. A retried remove() can report false if its
+ *    first attempt did reach the server.
+ *
+ * Callbacks run on a connection's I/O thread and should return quickly.
+ *
+ * The binary protocol serves the default namespace. command() sends any text
+ * command (a namespaced GET, CREATE, SCAN, ...) over its own connection.
+ */
+class BlacklistClient {
+public:
+    using Verdict = BinaryProtocol::Verdict;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string host = "127.0.0.1";
+        int port = 5555;
+        std::string unixPath;                    // If set, connect to this Unix socket instead of host:port
+        size_t connections = 4;
+        size_t maxBatch = 256;                   // Most URLs per BATCH_GET frame
+        size_t maxInFlight = 256;                // Most unanswered requests per connection; the rest wait queued
+        std::chrono::milliseconds timeout{2000};  // Longest silence while requests are outstanding
+        int retries = 2;
+    };
+
+    // Outcome of one request, as passed to callbacks
+    struct Reply {
+        bool ok = false;                                        // False: not answered; see error
+        BinaryProtocol::Status status = BinaryProtocol::STATUS_BAD_REQUEST;
+        Verdict verdict = BinaryProtocol::VERDICT_ABSENT;       // For checks answered STATUS_OK
+        std::string error;
+    };
+    using Callback = std::function<void(const Reply&)>;
+
+    // Thrown by futures and command() when a request can't be answered
+    class Error : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    struct Stats {
+        uint64_t requests = 0;     // Calls made
+        uint64_t frames = 0;       // Frames sent, batches counting once
+        uint64_t batched = 0;      // Checks sent in a BATCH_GET with others
+        uint64_t retries = 0;
+        uint64_t timeouts = 0;     // Connections reopened for going silent
+        uint64_t connects = 0;     // Connections opened, including reconnects
+    };
+
+    BlacklistClient();
+    explicit BlacklistClient(const Options& options);
+
+    // Fails whatever is still queued or unanswered
+    ~BlacklistClient();
+
+    BlacklistClient(const BlacklistClient&) = delete;
+    BlacklistClient& operator=(const BlacklistClient&) = delete;
+
+    std::future<Verdict> check(const std::string& url);
+
+    // Verdicts in the order of `urls`
+    std::future<std::vector<Verdict>> checkAll(const std::vector<std::string>& urls);
+
+    // True if added; false if the server rejected the URL
+    std::future<bool> add(const std::string& url, uint32_t ttl = 0);
+
+    // True if the URL was listed
+    std::future<bool> remove(const std::string& url);
+
+    void check(const std::string& url, Callback callback);
+    void add(const std::string& url, uint32_t ttl, Callback callback);
+    void remove(const std::string& url, Callback callback);
+
+    /**
+     * @brief Sends one text protocol command on a new connection.
+     * @return The response, without its trailing newline.
+     * @throws Error if the server can't be reached or doesn't answer in time.
+     */
+    std::string command(const std::string& line);
+
+    Stats stats() const;
+
+private:
+    struct Request {
+        uint8_t op;
+        std::string url;
+        uint32_t ttl;
+        int attempts;
+        Clock::time_point queuedAt;
+        Callback callback;
+    };
+
+    // One frame sent and not yet answered
+    struct Frame {
+        uint8_t op;
+        std::vector<Request> requests;
+    };
+
+    struct Connection;
+
+    Options options;
+    std::mutex mutex;                  // Guards queue and stopping
+    std::deque<Request> queue;         // Requests no connection has picked up yet
+    bool stopping = false;
+    std::vector<std::unique_ptr<Connection>> pool;
+    std::atomic<size_t> nextWake{0};
+    std::atomic<size_t> connected{0};  // Pooled connections currently open
+
+    struct Counters {
+        std::atomic<uint64_t> requests{0}, frames{0}, batched{0}, retries{0}, timeouts{0}, connects{0};
+    } counters;
+
+    void submit(uint8_t op, const std::string& url, uint32_t ttl, Callback callback);
+
+    // Wakes one connection blocked with room for requests, if any
+    void wakeIdle();
+
+    // I/O loop of one pooled connection
+    void run(Connection& connection);
+
+    bool connect(Connection& connection);
+
+    // Turns queued requests into frames in the connection's output buffer
+    void pickUp(Connection& connection);
+
+    // Writes as much of the output buffer as the socket takes
+    void flush(Connection& connection);
+
+    void readResponses(Connection& connection);
+
+    // Hands each request of an answered frame its reply
+    static void complete(Frame& frame, const BinaryProtocol::Header& header, const char* payload);
+
+    static void fail(std::vector<Request>& requests, const std::string& error);
+
+    // Closes the connection, sending its unanswered requests again or failing them
+    void reset(Connection& connection, const std::string& error);
+
+    // Fails requests queued for longer than the timeout while nothing was connected
+    void failStale(const std::string& error);
+
+    // Connects to the server; returns a blocking socket, or -1 with error set
+    int openSocket(int timeoutMs, std::string& error) const;
+};
+
+#endif // BLACKLIST_CLIENT_H
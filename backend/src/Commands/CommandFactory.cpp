@@ -4,21 +4,58 @@
 #include "PostCommand.h"       // Concrete implementation of the POST command
 #include "GetCommand.h"        // Concrete implementation of the GET command
 #include "DeleteCommand.h"     // Concrete implementation of the DELETE command
+#include "SnapshotCommand.h"   // Concrete implementation of the SNAPSHOT command
+#include "DiffCommand.h"       // Concrete implementation of the DIFF command
+#include "StatsCommand.h"      // Concrete implementation of the STATS command
+#include "TraceCommand.h"      // Concrete implementation of the TRACE DUMP command
+#include "TopKCommand.h"       // Concrete implementation of the TOPK command
+#include "CreateCommand.h"     // Concrete implementation of the CREATE command
+#include "NamespacesCommand.h" // Concrete implementation of the NAMESPACES command
+#include "MultiGetCommand.h"   // GET across several namespaces
+#include "MemoryCommand.h"     // Concrete implementation of the MEMORY command
 
 // Factory method to create ICommand instances based on CommandType enum.
 // Each command type is mapped to its corresponding class that implements ICommand.
 //
-// @param type The type of command (POST, GET, DELETE_CMD)
-// @param url  The URL the command will operate on
+// @param parsed The parsed command (type, URL, and extra arguments)
+// @param namespaces The server's namespaces, for commands that aren't bound to one filter
 // @return A unique_ptr to an ICommand instance, or nullptr for an invalid type
-std::unique_ptr<ICommand> CommandFactory::create(CommandType type, const std::string& url) {
-    switch (type) {
+std::unique_ptr<ICommand> CommandFactory::create(const ParsedCommand& parsed, Namespaces& namespaces) {
+    const std::string& url = parsed.url;
+    switch (parsed.type) {
         case CommandType::POST:
-            return std::make_unique<PostCommand>(url);     // Create POST command
+            // Create POST command, with the TTL if one was given
+            return std::make_unique<PostCommand>(url, parsed.args.empty() ? 0 : std::stoull(parsed.args[0]));
         case CommandType::GET:
             return std::make_unique<GetCommand>(url);      // Create GET command
         case CommandType::DELETE_CMD:
             return std::make_unique<DeleteCommand>(url);   // Create DELETE command
+        case CommandType::SNAPSHOT:
+            return std::make_unique<SnapshotCommand>();    // Create SNAPSHOT command
+        case CommandType::DIFF:
+            return std::make_unique<DiffCommand>(std::stoull(parsed.args.at(0)));  // Create DIFF command
+        case CommandType::STATS:
+            return std::make_unique<StatsCommand>();       // Create STATS command
+        case CommandType::TRACE_DUMP:
+            return std::make_unique<TraceCommand>();       // Create TRACE DUMP command
+        case CommandType::TOPK: {
+            // The parser already checked the stream name and count
+            HotKeys::Stream stream = HotKeys::URLS;
+            HotKeys::streamByName(parsed.args.at(0), stream);
+            return std::make_unique<TopKCommand>(stream, std::stoul(parsed.args.at(1)));
+        }
+        case CommandType::CREATE: {
+            // The parser already validated the name, size and depths
+            std::vector<int> depths;
+            for (size_t i = 2; i < parsed.args.size(); ++i) depths.push_back(std::stoi(parsed.args[i]));
+            return std::make_unique<CreateCommand>(namespaces, parsed.args.at(0), std::stoul(parsed.args.at(1)), depths);
+        }
+        case CommandType::NAMESPACES:
+            return std::make_unique<NamespacesCommand>(namespaces);
+        case CommandType::MEMORY:
+            return std::make_unique<MemoryCommand>(namespaces);
+        case CommandType::MULTI_GET:
+            return std::make_unique<MultiGetCommand>(namespaces, parsed.args, url);
         default:
             return nullptr;  // Return null if the command type is invalid
     }
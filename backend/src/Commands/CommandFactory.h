@@ -7,6 +7,7 @@
 #include <string>   // For std::string
 #include "ICommand.h"  // Base interface for all command types
 #include "../Server/CommandParser.h"  // For CommandType enum definition
+#include "Bloom/Namespaces.h"          // For commands that work across namespaces
 
 /**
  * CommandFactory is a static factory class that creates ICommand objects.
@@ -16,13 +17,13 @@
 class CommandFactory {
 public:
     /**
-     * Creates a concrete ICommand object based on the given command type and URL.
+     * Creates a concrete ICommand object based on the parsed command type, URL and arguments.
      *
-     * @param type The CommandType (e.g., POST, GET, DELETE_CMD)
-     * @param url The URL that the command will operate on
+     * @param parsed The parsed command (type, URL, and extra arguments)
+     * @param namespaces The server's namespaces, for CREATE, NAMESPACES and multi-namespace GET
      * @return A unique_ptr to the corresponding ICommand implementation, or nullptr if the type is invalid
      */
-    static std::unique_ptr<ICommand> create(CommandType type, const std::string& url);
+    static std::unique_ptr<ICommand> create(const ParsedCommand& parsed, Namespaces& namespaces);
 };
 
 #endif // COMMAND_FACTORY_H
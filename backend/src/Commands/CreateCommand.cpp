@@ -0,0 +1,16 @@
+#include "CreateCommand.h"             // Declaration of CreateCommand
+
+// Constructor for CreateCommand
+CreateCommand::CreateCommand(Namespaces& namespaces, const std::string& name, size_t size, const std::vector<int>& depths)
+    : namespaces(namespaces), name(name), size(size), depths(depths) {}
+
+// Executes the CREATE command
+// Allocates the new filter from the arena shared by every namespace
+std::string CreateCommand::execute(BloomFilter&) {
+    switch (namespaces.create(name, size, depths)) {
+        case Namespaces::CreateResult::CREATED: return "201 Created";
+        case Namespaces::CreateResult::EXISTS: return "409 Conflict";
+        case Namespaces::CreateResult::TOO_LARGE: return "413 Content Too Large";
+        default: return "507 Insufficient Storage";
+    }
+}
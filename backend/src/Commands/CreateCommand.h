@@ -0,0 +1,44 @@
+#ifndef CREATE_COMMAND_H
+#define CREATE_COMMAND_H
+
+#include "ICommand.h"            // Base interface for command execution
+#include "Bloom/Namespaces.h"    // Registry the namespace is added to
+#include <string>                // For std::string
+#include <vector>                // For std::vector
+
+/**
+ * @brief Handles the CREATE command.
+ *
+ * Adds an empty namespace with its own size and hash depths. It is saved in
+ * its own file and listed in the manifest, so it survives restarts.
+ */
+class CreateCommand : public ICommand {
+public:
+    /**
+     * @brief Constructs a CreateCommand.
+     *
+     * @param namespaces The server's namespaces.
+     * @param name Name of the new namespace.
+     * @param size Number of bits in its filter.
+     * @param depths Its hash depths.
+     */
+    CreateCommand(Namespaces& namespaces, const std::string& name, size_t size, const std::vector<int>& depths);
+
+    /**
+     * @brief Executes the CREATE command.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "201 Created", "409 Conflict" if the name is taken,
+     *         "413 Content Too Large" if the size or a depth is over the server's limits, or
+     *         "507 Insufficient Storage" if the namespace limit is reached
+     */
+    std::string execute(BloomFilter& bloom) override;
+
+private:
+    Namespaces& namespaces;
+    std::string name;
+    size_t size;
+    std::vector<int> depths;
+};
+
+#endif // CREATE_COMMAND_H
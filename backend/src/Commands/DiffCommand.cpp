@@ -0,0 +1,12 @@
+#include "DiffCommand.h"               // Declaration of DiffCommand
+#include "FilterSnapshot.h"            // Shared bit array encoding
+
+// Constructor for DiffCommand
+// Initializes the command with the version the client already holds
+DiffCommand::DiffCommand(unsigned long long since) : since(since) {}
+
+// Executes the DIFF command
+// Encodes the words changed since the client's version
+std::string DiffCommand::execute(BloomFilter& bloom) {
+    return FilterSnapshot::encodeDiff(bloom, since);
+}
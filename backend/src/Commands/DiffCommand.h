@@ -0,0 +1,34 @@
+#ifndef DIFF_COMMAND_H
+#define DIFF_COMMAND_H
+
+#include "ICommand.h"   // Base interface for command execution
+#include <string>       // For std::string
+
+/**
+ * @brief Handles the DIFF command.
+ *
+ * Returns only the bit array words that changed after the version the client
+ * already holds. If the filter's dirty-word log no longer reaches back that far,
+ * a full snapshot is returned instead.
+ */
+class DiffCommand : public ICommand {
+private:
+    unsigned long long since;  // Version the client already holds
+
+public:
+    /**
+     * @brief Constructor that initializes the command with the client's version.
+     * @param since Version returned by an earlier SNAPSHOT or DIFF
+     */
+    explicit DiffCommand(unsigned long long since);
+
+    /**
+     * @brief Executes the DIFF command.
+     *
+     * @param bloom Reference to the BloomFilter instance
+     * @return "200 Ok" followed by a "diff" payload, or a full snapshot
+     */
+    std::string execute(BloomFilter& bloom) override;
+};
+
+#endif // DIFF_COMMAND_H
@@ -0,0 +1,77 @@
+#include "FilterSnapshot.h"
+#include "Bloom/BloomFilter.h"
+
+#include <cstdio>     // For std::snprintf
+#include <cstdint>
+
+namespace {
+
+// Appends a word as 16 lowercase hex digits
+void appendHexWord(std::string& out, uint64_t word) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(word));
+    out.append(buf, 16);
+}
+
+// Appends "<index>:<hex word>" pairs, separated by spaces
+void appendPairs(std::string& out, const std::vector<uint64_t>& words, const std::vector<size_t>& indices) {
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (i) out += ' ';
+        out += std::to_string(indices[i]);
+        out += ':';
+        appendHexWord(out, words[indices[i]]);
+    }
+}
+
+// Header line shared by every reply: version, bit count and hash depths
+std::string header(const BloomFilter& bloom) {
+    std::string out = "200 Ok\n\n";
+    out += std::to_string(bloom.getVersion()) + " " + std::to_string(bloom.size());
+    for (int depth : bloom.getHashConfig()) {
+        out += " " + std::to_string(depth);
+    }
+    out += "\n";
+    return out;
+}
+
+} // namespace
+
+std::string FilterSnapshot::encodeSnapshot(const BloomFilter& bloom) {
+    const std::vector<uint64_t>& words = bloom.words();
+
+    // Gather the non-zero words and the size of their sparse encoding
+    std::vector<size_t> nonZero;
+    size_t sparseBytes = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (words[i]) {
+            nonZero.push_back(i);
+            sparseBytes += std::to_string(i).size() + 18;  // index, ':', 16 digits, separator
+        }
+    }
+
+    std::string out = header(bloom);
+    if (sparseBytes < words.size() * 16) {
+        out += "sparse " + std::to_string(nonZero.size()) + "\n";
+        out.reserve(out.size() + sparseBytes);
+        appendPairs(out, words, nonZero);
+    } else {
+        out += "dense " + std::to_string(words.size()) + "\n";
+        out.reserve(out.size() + words.size() * 16);
+        for (uint64_t word : words) {
+            appendHexWord(out, word);
+        }
+    }
+    return out;
+}
+
+std::string FilterSnapshot::encodeDiff(const BloomFilter& bloom, unsigned long long since) {
+    std::vector<size_t> changed;
+    if (!bloom.changedWordsSince(since, changed)) {
+        return encodeSnapshot(bloom);  // Too old (or unknown) to diff against
+    }
+
+    std::string out = header(bloom);
+    out += "diff " + std::to_string(changed.size()) + "\n";
+    appendPairs(out, bloom.words(), changed);
+    return out;
+}
@@ -0,0 +1,35 @@
+#ifndef FILTER_SNAPSHOT_H
+#define FILTER_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+class BloomFilter;
+
+/**
+ * Text encoding of the filter's bit array, shared by SNAPSHOT and DIFF.
+ *
+ * Both replies start with a header line "<version> <bit count> <depth 1> <depth 2> ..."
+ * followed by a line "<kind> <count>" and the payload:
+ *  - "sparse <n>": full snapshot, n "<word index>:<hex word>" pairs for the non-zero words
+ *  - "dense <n>":  full snapshot, all n words as 16 hex digits each, back to back
+ *  - "diff <n>":   n "<word index>:<hex word>" pairs that replace the client's copy
+ *
+ * Bit i of the filter is bit (i % 64) of word (i / 64). A sparse snapshot is sent
+ * whenever it is smaller than the dense one, which keeps mostly-empty filters cheap.
+ */
+namespace FilterSnapshot {
+
+    /**
+     * Encodes the full bit array, picking the smaller of the sparse and dense forms.
+     */
+    std::string encodeSnapshot(const BloomFilter& bloom);
+
+    /**
+     * Encodes only the words that changed after the given version, or a full
+     * snapshot if the filter can no longer tell what changed since then.
+     */
+    std::string encodeDiff(const BloomFilter& bloom, unsigned long long since);
+}
+
+#endif // FILTER_SNAPSHOT_H
@@ -1,5 +1,4 @@
 #include <string>
-#include <sstream>
 #include "GetCommand.h"                 // Declaration of GetCommand
 #include "Bloom/BloomFilter.h"         // BloomFilter class to check and double-check URLs
 
@@ -21,17 +20,13 @@ std::string GetCommand::execute(BloomFilter& bloom) {
     }
 
     bool bloomResult = bloom.check(url);  // Check via Bloom filter (fast but might be false-positive)
-    std::ostringstream response;
-    response << "200 Ok\n\n";             // Always return 200 if the input format was valid
 
-    if (bloomResult) {
-        // If Bloom filter *may* contain the URL, perform a real lookup
-        bool isActuallyBlacklisted = bloom.doubleCheck(url);  // Check in the actual std::set
-        response << "true " << (isActuallyBlacklisted ? "true" : "false");
-    } else {
-        // Definitely not in the Bloom filter
-        response << "false";
-    }
+    // If Bloom filter *may* contain the URL, perform a real lookup in the actual std::set
+    return format(bloomResult, bloomResult && bloom.doubleCheck(url));
+}
 
-    return response.str();  // Return the full formatted response
+// Builds the response for a verdict; always 200 since the input format was valid
+std::string GetCommand::format(bool positive, bool blacklisted) {
+    if (!positive) return "200 Ok\n\nfalse";  // Definitely not in the Bloom filter
+    return blacklisted ? "200 Ok\n\ntrue true" : "200 Ok\n\ntrue false";
 }
@@ -33,6 +33,14 @@ public:
      *         - "true false" (false positive from the Bloom filter)
      */
     std::string execute(BloomFilter& bloom) override;
+
+    /**
+     * @brief Formats a GET response from its verdict, e.g. one taken from the verdict cache.
+     *
+     * @param positive Whether the Bloom filter matched the URL
+     * @param blacklisted Whether the exact blacklist confirmed it
+     */
+    static std::string format(bool positive, bool blacklisted);
 };
 
 #endif // GET_COMMAND_H
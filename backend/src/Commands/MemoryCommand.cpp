@@ -0,0 +1,11 @@
+#include "MemoryCommand.h"             // Declaration of MemoryCommand
+#include "Server/MemoryStats.h"        // Connection buffers and process-wide figures
+
+// Constructor for MemoryCommand
+MemoryCommand::MemoryCommand(Namespaces& namespaces) : namespaces(namespaces) {}
+
+// Executes the MEMORY command
+// The filters' figures come first, then the rest of the process
+std::string MemoryCommand::execute(BloomFilter&) {
+    return "200 Ok\n\n" + namespaces.formatMemory() + "\n" + MemoryStats::instance().format();
+}
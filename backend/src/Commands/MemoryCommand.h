@@ -0,0 +1,38 @@
+#ifndef MEMORY_COMMAND_H
+#define MEMORY_COMMAND_H
+
+#include "ICommand.h"            // Base interface for command execution
+#include "Bloom/Namespaces.h"    // Filters being reported on
+#include <string>                // For std::string
+
+/**
+ * @brief Handles the MEMORY command.
+ *
+ * Reports where the process's memory goes: one line per namespace with its
+ * fill ratio, estimated false positive rate, the bytes of each part of the
+ * filter and bytes per stored URL, then "name value" lines with the live
+ * bytes and allocation counts of each component, the shared arena, the
+ * connection buffers, the heap, resident memory and thread stacks.
+ */
+class MemoryCommand : public ICommand {
+public:
+    /**
+     * @brief Constructs a MemoryCommand.
+     *
+     * @param namespaces The server's namespaces.
+     */
+    explicit MemoryCommand(Namespaces& namespaces);
+
+    /**
+     * @brief Executes the MEMORY command.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "200 Ok" followed by the namespace lines and the "name value" lines
+     */
+    std::string execute(BloomFilter& bloom) override;
+
+private:
+    Namespaces& namespaces;
+};
+
+#endif // MEMORY_COMMAND_H
@@ -0,0 +1,30 @@
+#include "MultiGetCommand.h"           // Declaration of MultiGetCommand
+
+// Constructor for MultiGetCommand
+MultiGetCommand::MultiGetCommand(Namespaces& namespaces, const std::vector<std::string>& names, const std::string& url)
+    : namespaces(namespaces), names(names), url(url) {}
+
+// Executes the lookup in every namespace
+// Nothing is counted unless every namespace exists
+std::string MultiGetCommand::execute(BloomFilter&) {
+    std::vector<Namespaces::Namespace*> targets;
+    for (const auto& name : names) {
+        Namespaces::Namespace* ns = namespaces.find(name);
+        if (!ns) return "404 Not Found";
+        targets.push_back(ns);
+    }
+
+    std::string response = "200 Ok\n";
+    for (Namespaces::Namespace* ns : targets) {
+        ns->filter->expire();
+        bool positive = ns->filter->check(url);
+        bool blacklisted = positive && ns->filter->doubleCheck(url);
+        ns->recordGet(positive, blacklisted);
+        if (ns->cache) {
+            ns->cache->insert(url, !positive ? VerdictCache::ABSENT
+                                   : blacklisted ? VerdictCache::BLACKLISTED : VerdictCache::FALSE_POSITIVE, *ns->filter);
+        }
+        response += "\n" + ns->name + (positive ? (blacklisted ? " true true" : " true false") : " false");
+    }
+    return response;
+}
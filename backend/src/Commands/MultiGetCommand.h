@@ -0,0 +1,41 @@
+#ifndef MULTI_GET_COMMAND_H
+#define MULTI_GET_COMMAND_H
+
+#include "ICommand.h"            // Base interface for command execution
+#include "Bloom/Namespaces.h"    // Namespaces being checked
+#include <string>                // For std::string
+#include <vector>                // For std::vector
+
+/**
+ * @brief Handles GET with a list of namespaces ("GET phishing,org-a,allow <url>").
+ *
+ * Checks the URL in every listed namespace under one acquisition of the
+ * filter lock, so the verdicts are consistent with each other.
+ */
+class MultiGetCommand : public ICommand {
+public:
+    /**
+     * @brief Constructs a MultiGetCommand.
+     *
+     * @param namespaces The server's namespaces.
+     * @param names Namespaces to check, in the order to report them.
+     * @param url The URL to check.
+     */
+    MultiGetCommand(Namespaces& namespaces, const std::vector<std::string>& names, const std::string& url);
+
+    /**
+     * @brief Executes the lookup.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "200 Ok" followed by one "<namespace> <verdict>" line per namespace,
+     *         the verdict formatted as for GET, or "404 Not Found" if a namespace doesn't exist
+     */
+    std::string execute(BloomFilter& bloom) override;
+
+private:
+    Namespaces& namespaces;
+    std::vector<std::string> names;
+    std::string url;
+};
+
+#endif // MULTI_GET_COMMAND_H
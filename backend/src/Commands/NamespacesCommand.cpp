@@ -0,0 +1,9 @@
+#include "NamespacesCommand.h"         // Declaration of NamespacesCommand
+
+// Constructor for NamespacesCommand
+NamespacesCommand::NamespacesCommand(Namespaces& namespaces) : namespaces(namespaces) {}
+
+// Executes the NAMESPACES command
+std::string NamespacesCommand::execute(BloomFilter&) {
+    return "200 Ok\n\n" + namespaces.format() + "\narena_bytes " + std::to_string(namespaces.mappedBytes());
+}
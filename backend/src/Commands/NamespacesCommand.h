@@ -0,0 +1,35 @@
+#ifndef NAMESPACES_COMMAND_H
+#define NAMESPACES_COMMAND_H
+
+#include "ICommand.h"            // Base interface for command execution
+#include "Bloom/Namespaces.h"    // Registry being listed
+#include <string>                // For std::string
+
+/**
+ * @brief Handles the NAMESPACES command.
+ *
+ * Lists every namespace with its size, hash depths, URL count and request
+ * counters, followed by the memory mapped by the arena they share.
+ */
+class NamespacesCommand : public ICommand {
+public:
+    /**
+     * @brief Constructs a NamespacesCommand.
+     *
+     * @param namespaces The server's namespaces.
+     */
+    explicit NamespacesCommand(Namespaces& namespaces);
+
+    /**
+     * @brief Executes the NAMESPACES command.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "200 Ok" followed by one line per namespace and an "arena_bytes" line
+     */
+    std::string execute(BloomFilter& bloom) override;
+
+private:
+    Namespaces& namespaces;
+};
+
+#endif // NAMESPACES_COMMAND_H
@@ -3,8 +3,8 @@
 
 
 // Constructor for PostCommand
-// Initializes the command with the provided URL
-PostCommand::PostCommand(const std::string& url) : url(url) {}
+// Initializes the command with the provided URL and optional TTL
+PostCommand::PostCommand(const std::string& url, uint64_t ttl) : url(url), ttl(ttl) {}
 
 
 // Executes the POST command logic
@@ -12,6 +12,6 @@ PostCommand::PostCommand(const std::string& url) : url(url) {}
 //
 // Returns an HTTP-style response string indicating success.
 std::string PostCommand::execute(BloomFilter& bloom) {
-    bloom.add(url);                   // Insert the URL into the Bloom filter and underlying set
+    bloom.add(url, ttl);              // Insert the URL into the Bloom filter and underlying set
     return "201 Created";             // Response indicating the resource (URL) was added
 }
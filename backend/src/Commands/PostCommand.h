@@ -3,6 +3,7 @@
 
 #include "ICommand.h"   // Base interface for command execution
 #include <string>       // For std::string
+#include <cstdint>      // For uint64_t
 
 /**
  * @brief Handles the POST command.
@@ -13,13 +14,15 @@
 class PostCommand : public ICommand {
 private:
     std::string url;  // The URL to be added to the blacklist
+    uint64_t ttl;     // Seconds until the URL expires; 0 for the filter's default
 
 public:
     /**
      * @brief Constructor to initialize the command with a given URL.
      * @param url The URL that will be added to the Bloom filter
+     * @param ttl Seconds until the URL expires; 0 for the filter's default
      */
-    explicit PostCommand(const std::string& url);
+    explicit PostCommand(const std::string& url, uint64_t ttl = 0);
 
     /**
      * @brief Executes the POST operation.
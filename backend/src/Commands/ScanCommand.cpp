@@ -0,0 +1,18 @@
+#include "ScanCommand.h"               // Declaration of ScanCommand
+#include "Bloom/BloomFilter.h"         // BloomFilter class to check and double-check URLs
+
+// Constructor for ScanCommand
+ScanCommand::ScanCommand(const std::vector<std::string>& urls) : urls(urls) {}
+
+// Executes the SCAN command
+// Only URLs the exact blacklist confirms are listed, as for a "true true" GET
+std::string ScanCommand::execute(BloomFilter& bloom) {
+    std::string blacklisted;
+    size_t count = 0;
+    for (const auto& url : urls) {
+        if (!bloom.check(url) || !bloom.doubleCheck(url)) continue;
+        blacklisted += "\n" + url;
+        ++count;
+    }
+    return "200 Ok\n\nurls " + std::to_string(urls.size()) + " blacklisted " + std::to_string(count) + blacklisted;
+}
@@ -0,0 +1,37 @@
+#ifndef SCAN_COMMAND_H
+#define SCAN_COMMAND_H
+
+#include "ICommand.h"   // Base interface for command execution
+#include <string>       // For std::string
+#include <vector>       // For std::vector
+
+/**
+ * @brief Handles the SCAN command - checks every URL found in a mail at once.
+ *
+ * The server extracts the URLs from the SCAN body while it arrives (see
+ * UrlScanner.h); this command then checks each one as GET would, under a
+ * single acquisition of the filter lock.
+ */
+class ScanCommand : public ICommand {
+public:
+    /**
+     * @brief Constructs a ScanCommand.
+     *
+     * @param urls Distinct URLs found in the body.
+     */
+    explicit ScanCommand(const std::vector<std::string>& urls);
+
+    /**
+     * @brief Executes the SCAN command.
+     *
+     * @param bloom Reference to the BloomFilter object
+     * @return "200 Ok", then "urls <found> blacklisted <count>", then one line
+     *         per blacklisted URL in the order they appear in the body
+     */
+    std::string execute(BloomFilter& bloom) override;
+
+private:
+    std::vector<std::string> urls;
+};
+
+#endif // SCAN_COMMAND_H
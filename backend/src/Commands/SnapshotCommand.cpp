@@ -0,0 +1,8 @@
+#include "SnapshotCommand.h"           // Declaration of SnapshotCommand
+#include "FilterSnapshot.h"            // Shared bit array encoding
+
+// Executes the SNAPSHOT command
+// Encodes the full bit array (sparse or dense, whichever is smaller)
+std::string SnapshotCommand::execute(BloomFilter& bloom) {
+    return FilterSnapshot::encodeSnapshot(bloom);
+}
@@ -0,0 +1,25 @@
+#ifndef SNAPSHOT_COMMAND_H
+#define SNAPSHOT_COMMAND_H
+
+#include "ICommand.h"   // Base interface for command execution
+#include <string>       // For std::string
+
+/**
+ * @brief Handles the SNAPSHOT command.
+ *
+ * Returns the whole packed bit array together with the hash depths and the
+ * current version, so a client can keep a local read-only copy of the filter
+ * and only contact the server when its copy reports a possible match.
+ */
+class SnapshotCommand : public ICommand {
+public:
+    /**
+     * @brief Executes the SNAPSHOT command.
+     *
+     * @param bloom Reference to the BloomFilter instance
+     * @return "200 Ok" followed by the encoding described in FilterSnapshot.h
+     */
+    std::string execute(BloomFilter& bloom) override;
+};
+
+#endif // SNAPSHOT_COMMAND_H
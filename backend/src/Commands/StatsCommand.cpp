@@ -0,0 +1,8 @@
+#include "StatsCommand.h"              // Declaration of StatsCommand
+#include "Server/ServerStats.h"        // Process-wide server counters
+
+// Executes the STATS command
+// Lists every counter; the filter itself isn't involved
+std::string StatsCommand::execute(BloomFilter&) {
+    return "200 Ok\n\n" + ServerStats::instance().format();
+}
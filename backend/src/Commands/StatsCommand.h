@@ -0,0 +1,24 @@
+#ifndef STATS_COMMAND_H
+#define STATS_COMMAND_H
+
+#include "ICommand.h"   // Base interface for command execution
+#include <string>       // For std::string
+
+/**
+ * @brief Handles the STATS command.
+ *
+ * Reports the server's connection counters (see ServerStats), including how
+ * many connections were shed by the limits and closed by the timeouts.
+ */
+class StatsCommand : public ICommand {
+public:
+    /**
+     * @brief Executes the STATS command.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "200 Ok" followed by one "name value" line per counter
+     */
+    std::string execute(BloomFilter& bloom) override;
+};
+
+#endif // STATS_COMMAND_H
@@ -0,0 +1,14 @@
+#include "TopKCommand.h"               // Declaration of TopKCommand
+
+// Constructor for TopKCommand
+TopKCommand::TopKCommand(HotKeys::Stream stream, size_t count) : stream(stream), count(count) {}
+
+// Executes the TOPK command
+// Counts are estimates: they may be slightly high, never low
+std::string TopKCommand::execute(BloomFilter&) {
+    std::string response = "200 Ok\n";
+    for (const auto& entry : HotKeys::instance().top(stream, count)) {
+        response += "\n" + entry.first + " " + std::to_string(entry.second);
+    }
+    return response;
+}
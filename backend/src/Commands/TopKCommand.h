@@ -0,0 +1,37 @@
+#ifndef TOPK_COMMAND_H
+#define TOPK_COMMAND_H
+
+#include "ICommand.h"            // Base interface for command execution
+#include "Analytics/HotKeys.h"   // For HotKeys::Stream
+#include <string>                // For std::string
+
+/**
+ * @brief Handles the TOPK command.
+ *
+ * Lists the most frequent keys of one heavy-hitter stream (see HotKeys.h):
+ * queried URLs or domains, false positives, or domains added by POST.
+ */
+class TopKCommand : public ICommand {
+public:
+    /**
+     * @brief Constructs a TopKCommand.
+     *
+     * @param stream The stream to report.
+     * @param count How many keys to list.
+     */
+    TopKCommand(HotKeys::Stream stream, size_t count);
+
+    /**
+     * @brief Executes the TOPK command.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "200 Ok" followed by one "key count" line per key, most frequent first
+     */
+    std::string execute(BloomFilter& bloom) override;
+
+private:
+    HotKeys::Stream stream;
+    size_t count;
+};
+
+#endif // TOPK_COMMAND_H
@@ -0,0 +1,8 @@
+#include "TraceCommand.h"              // Declaration of TraceCommand
+#include "Trace/Trace.h"               // Span export
+
+// Executes the TRACE DUMP command
+// Formats every span in the rings; the filter itself isn't involved
+std::string TraceCommand::execute(BloomFilter&) {
+    return "200 Ok\n\n" + Trace::dumpChromeJson();
+}
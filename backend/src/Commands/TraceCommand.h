@@ -0,0 +1,24 @@
+#ifndef TRACE_COMMAND_H
+#define TRACE_COMMAND_H
+
+#include "ICommand.h"   // Base interface for command execution
+#include <string>       // For std::string
+
+/**
+ * @brief Handles the TRACE DUMP command.
+ *
+ * Exports the request spans still held in the tracing ring buffers (see
+ * Trace.h) as Chrome trace JSON, to find where slow requests spent their time.
+ */
+class TraceCommand : public ICommand {
+public:
+    /**
+     * @brief Executes the TRACE DUMP command.
+     *
+     * @param bloom Reference to the BloomFilter instance (unused)
+     * @return "200 Ok" followed by the trace JSON
+     */
+    std::string execute(BloomFilter& bloom) override;
+};
+
+#endif // TRACE_COMMAND_H
@@ -0,0 +1,198 @@
+#include "UrlScanner.h"
+
+#include <cstring>                     // For std::memcmp
+
+#if defined(__x86_64__)
+#include <immintrin.h>                 // SSE2 and AVX2 compares
+#endif
+
+namespace {
+
+// Character classes, looked up once per byte while validating around a dot
+enum : uint8_t { SPACE = 1, ALPHA = 2, LABEL = 4 };
+
+struct CharClasses {
+    uint8_t of[256] = {};
+
+    CharClasses() {
+        for (int c : {' ', '\t', '\n', '\r', '\f', '\v'}) of[c] = SPACE;
+        for (int c = 'a'; c <= 'z'; ++c) of[c] = ALPHA | LABEL;
+        for (int c = 'A'; c <= 'Z'; ++c) of[c] = ALPHA | LABEL;
+        for (int c = '0'; c <= '9'; ++c) of[c] = LABEL;
+        of[static_cast<int>('-')] = LABEL;
+    }
+};
+
+const CharClasses CLASSES;
+
+bool isSpace(char c) { return CLASSES.of[static_cast<uint8_t>(c)] & SPACE; }
+
+bool isAlpha(char c) { return CLASSES.of[static_cast<uint8_t>(c)] & ALPHA; }
+
+// Characters of one host label: [a-zA-Z0-9-]
+bool isLabel(char c) { return CLASSES.of[static_cast<uint8_t>(c)] & LABEL; }
+
+// Punctuation that more likely ends the sentence than the URL
+bool isTrailingPunctuation(char c) {
+    switch (c) {
+        case '.': case ',': case ';': case ':': case '!': case '?':
+        case '\'': case '"': case ')': case ']': case '}': case '>':
+            return true;
+        default:
+            return false;
+    }
+}
+
+const char* findDotScalar(const char* pos, const char* end) {
+    while (pos < end && *pos != '.') ++pos;
+    return pos;
+}
+
+#if defined(__x86_64__)
+
+// 16 bytes per compare; SSE2 is part of x86-64, so this needs no check
+const char* findDotSse2(const char* pos, const char* end) {
+    const __m128i dot = _mm_set1_epi8('.');
+    while (end - pos >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, dot));
+        if (mask) return pos + __builtin_ctz(static_cast<unsigned>(mask));
+        pos += 16;
+    }
+    return findDotScalar(pos, end);
+}
+
+__attribute__((target("avx2")))
+const char* findDotAvx2(const char* pos, const char* end) {
+    const __m256i dot = _mm256_set1_epi8('.');
+    while (end - pos >= 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, dot)));
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 32;
+    }
+    return findDotSse2(pos, end);
+}
+
+#endif
+
+} // namespace
+
+UrlScanner::UrlScanner(Simd simd) : findDot(findDotScalar) {
+#if defined(__x86_64__)
+    if (simd == Simd::SSE2) findDot = findDotSse2;
+    if (simd == Simd::AVX2) findDot = findDotAvx2;
+#else
+    (void)simd;
+#endif
+}
+
+UrlScanner::Simd UrlScanner::best() {
+#if defined(__x86_64__)
+    return __builtin_cpu_supports("avx2") ? Simd::AVX2 : Simd::SSE2;
+#else
+    return Simd::SCALAR;
+#endif
+}
+
+const char* UrlScanner::name(Simd simd) {
+    switch (simd) {
+        case Simd::SSE2: return "sse2";
+        case Simd::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+void UrlScanner::feed(const char* data, size_t size) {
+    bytes += size;
+    const char* end = data + size;
+
+    // The word carried over from the last chunk ends at the first whitespace
+    const char* first = data;
+    while (first < end && !isSpace(*first)) ++first;
+    if (first == end) {
+        carry.append(data, size);
+        if (carry.size() > MAX_WORD) {  // Not text; scan what we have rather than keep growing
+            scanRegion(carry.data(), carry.data() + carry.size());
+            carry.clear();
+        }
+        return;
+    }
+
+    // Everything up to the last whitespace can be scanned in place
+    const char* last = end;
+    while (!isSpace(last[-1])) --last;
+    if (carry.empty()) {
+        scanRegion(data, last);
+    } else {
+        carry.append(data, first - data);
+        scanRegion(carry.data(), carry.data() + carry.size());
+        scanRegion(first, last);
+    }
+    carry.assign(last, end);
+}
+
+void UrlScanner::finish() {
+    scanRegion(carry.data(), carry.data() + carry.size());
+    carry.clear();
+}
+
+void UrlScanner::scanRegion(const char* begin, const char* end) {
+    const char* pos = begin;  // Text before this already belongs to a match or was ruled out
+    const char* dot = findDot(begin, end);
+    while (dot < end) {
+        const char *start, *hostEnd, *stop;
+        if (match(pos, dot, end, start, hostEnd, stop)) add(start, hostEnd, stop);
+        pos = stop;
+        dot = findDot(pos, end);
+    }
+}
+
+bool UrlScanner::match(const char* pos, const char* dot, const char* end,
+                       const char*& start, const char*& hostEnd, const char*& stop) {
+    // The first label runs back from the dot
+    const char* label = dot;
+    while (label > pos && isLabel(label[-1])) --label;
+    stop = dot + 1;
+    if (label == dot) return false;
+
+    // Walk the labels that follow. The regex backtracks to the last dot that is
+    // followed by two or more letters, which end the top-level domain.
+    const char* best = nullptr;
+    const char* q = dot;
+    while (true) {
+        const char* tld = q + 1;
+        while (tld < end && isAlpha(*tld)) ++tld;
+        if (tld - q > 2) best = tld;
+
+        const char* next = q + 1;
+        while (next < end && isLabel(*next)) ++next;
+        if (next == q + 1 || next == end || *next != '.') {
+            // No dot in the labels walked can start a match either, so skip them
+            if (!best) stop = next;
+            break;
+        }
+        q = next;
+    }
+    if (!best) return false;
+
+    start = label;
+    if (label - pos >= 8 && std::memcmp(label - 8, "https://", 8) == 0) start = label - 8;
+    else if (label - pos >= 7 && std::memcmp(label - 7, "http://", 7) == 0) start = label - 7;
+
+    hostEnd = stop = best;
+    if (stop < end && *stop == '/') {
+        while (stop < end && !isSpace(*stop)) ++stop;
+    }
+    return true;
+}
+
+void UrlScanner::add(const char* start, const char* hostEnd, const char* stop) {
+    const char* end = stop;
+    while (end > hostEnd + 1 && isTrailingPunctuation(end[-1])) --end;
+    if (end == hostEnd + 1) end = hostEnd;  // A bare "/" path
+    if (static_cast<size_t>(end - start) > MAX_URL) return;
+
+    std::string url(start, end);
+    if (seen.insert(url).second) found.push_back(std::move(url));
+}
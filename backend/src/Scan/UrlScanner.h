@@ -0,0 +1,83 @@
+#ifndef URL_SCANNER_H
+#define URL_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Finds the URLs in free text (a mail subject or body), fed in chunks.
+ *
+ * Accepts the same URLs as the API's extractUrls() regex:
+ *   (https?://)?(www.)?([a-zA-Z0-9-]+.)+[a-zA-Z]{2,}(/\S*)?
+ * Every match contains a dot, so the scanner only looks for dots, with SIMD
+ * compares over 16 or 32 bytes at a time, and validates the text around each
+ * one: labels to the left, more labels and the top-level domain to the right,
+ * an "http://" or "https://" just before, and a path up to the next whitespace.
+ *
+ * Matches are canonicalized before being reported: punctuation that ends a
+ * sentence is trimmed off the path ("see foo.com/x." gives "foo.com/x") and a
+ * bare "/" path is dropped. Host case is kept, because the blacklist matches
+ * URLs exactly as they were posted. Each URL is reported once. extractUrls()
+ * canonicalizes the same way, so what the API blacklists is what SCAN finds.
+ *
+ * URLs never contain whitespace, so everything up to the last whitespace of a
+ * chunk is scanned right away; only the unfinished word is carried over.
+ */
+class UrlScanner {
+public:
+    // Instruction set used to look for dots
+    enum class Simd { SCALAR, SSE2, AVX2 };
+
+    static const size_t MAX_URL = 8192;      // Longer matches are dropped: the server never accepts them
+    static const size_t MAX_WORD = 65536;    // Longest run without whitespace carried between chunks
+    static const size_t MAX_BODY = 1 << 26;  // Largest SCAN body the server accepts
+
+    /**
+     * @param simd Dot search to use; defaults to the best one this CPU supports.
+     */
+    explicit UrlScanner(Simd simd = best());
+
+    /**
+     * @brief Scans the next chunk of text.
+     */
+    void feed(const char* data, size_t size);
+
+    /**
+     * @brief Scans what is left after the last chunk. Call once, before urls().
+     */
+    void finish();
+
+    // Distinct canonical URLs, in order of first appearance
+    const std::vector<std::string>& urls() const { return found; }
+
+    // Bytes fed so far
+    uint64_t scannedBytes() const { return bytes; }
+
+    // Best dot search this CPU supports
+    static Simd best();
+
+    static const char* name(Simd simd);
+
+private:
+    const char* (*findDot)(const char* pos, const char* end);
+    std::string carry;                        // Unfinished word from the previous chunk
+    std::vector<std::string> found;
+    std::unordered_set<std::string> seen;
+    uint64_t bytes = 0;
+
+    // Scans text that starts and ends at a word boundary
+    void scanRegion(const char* begin, const char* end);
+
+    // Validates the text around the dot at `dot`, not looking back before `pos`.
+    // On a match, sets where it starts, where its host ends and where it ends.
+    static bool match(const char* pos, const char* dot, const char* end,
+                      const char*& start, const char*& hostEnd, const char*& stop);
+
+    // Canonicalizes and records one match
+    void add(const char* start, const char* hostEnd, const char* stop);
+};
+
+#endif // URL_SCANNER_H
@@ -0,0 +1,76 @@
+#include "BinaryProtocol.h"
+
+namespace {
+
+uint32_t readU32(const char* p) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return (uint32_t(u[0]) << 24) | (uint32_t(u[1]) << 16) | (uint32_t(u[2]) << 8) | uint32_t(u[3]);
+}
+
+void appendU32(std::string& out, uint32_t value) {
+    out += static_cast<char>(value >> 24);
+    out += static_cast<char>(value >> 16);
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value);
+}
+
+} // namespace
+
+bool BinaryProtocol::decodeHeader(const char* data, Header& header) {
+    if (static_cast<uint8_t>(data[0]) != MAGIC) return false;
+    header.version = static_cast<uint8_t>(data[1]);
+    header.code = static_cast<uint8_t>(data[2]);
+    header.flags = static_cast<uint8_t>(data[3]);
+    header.requestId = readU32(data + 4);
+    header.length = readU32(data + 8);
+    return header.version == VERSION;
+}
+
+void BinaryProtocol::appendFrame(std::string& out, uint8_t code, uint32_t requestId, const std::string& payload,
+                                 uint8_t flags) {
+    out += static_cast<char>(MAGIC);
+    out += static_cast<char>(VERSION);
+    out += static_cast<char>(code);
+    out += static_cast<char>(flags);
+    appendU32(out, requestId);
+    appendU32(out, static_cast<uint32_t>(payload.size()));
+    out += payload;
+}
+
+void BinaryProtocol::appendBatchUrl(std::string& payload, const std::string& url) {
+    payload += static_cast<char>(url.size() >> 8);
+    payload += static_cast<char>(url.size() & 0xFF);
+    payload += url;
+}
+
+bool BinaryProtocol::parseBatch(const std::string& payload, std::vector<std::string>& urls) {
+    urls.clear();
+    size_t pos = 0;
+    while (pos < payload.size()) {
+        if (payload.size() - pos < 2) return false;
+        size_t length = (size_t(static_cast<unsigned char>(payload[pos])) << 8) |
+                        static_cast<unsigned char>(payload[pos + 1]);
+        pos += 2;
+        if (payload.size() - pos < length) return false;
+        urls.emplace_back(payload, pos, length);
+        pos += length;
+    }
+    return true;
+}
+
+void BinaryProtocol::appendPost(std::string& payload, const std::string& url, uint32_t ttl) {
+    if (ttl) appendU32(payload, ttl);
+    payload += url;
+}
+
+bool BinaryProtocol::parsePost(const Header& header, const std::string& payload, std::string& url, uint32_t& ttl) {
+    if (!(header.flags & FLAG_TTL)) {
+        ttl = 0;
+        url = payload;
+        return true;
+    }
+    if (payload.size() < 4) return false;
+    ttl = readU32(payload.data());
+    url = payload.substr(4);
+    return true;
+}
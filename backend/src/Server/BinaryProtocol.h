@@ -0,0 +1,104 @@
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Compact binary framing, served on the same port as the text protocol.
+ *
+ * A connection is binary if its first byte is MAGIC, which can't start a text
+ * command. Binary connections stay open for any number of frames; the client
+ * closes them. All integers are big-endian (network order).
+ *
+ * Request frame:  magic u8 | version u8 | opcode u8 | flags u8 | request id u32 | payload length u32 | payload
+ * Response frame: magic u8 | version u8 | status u8 | 0 u8     | request id u32 | payload length u32 | payload
+ *
+ * Payloads:
+ *  - GET, POST, DELETE: the URL. GET answers with one Verdict byte.
+ *    A POST with FLAG_TTL set is prefixed with a u32 TTL in seconds.
+ *  - BATCH_GET: repeated (u16 URL length | URL); answers with one Verdict byte per URL.
+ *
+ * Responses carry the request ID of the frame they answer. Clients must match
+ * on it rather than assume responses arrive in request order.
+ */
+namespace BinaryProtocol {
+
+    const uint8_t MAGIC = 0xB7;                 // Not printable ASCII, so never the start of a text command
+    const uint8_t VERSION = 1;
+    const size_t HEADER_SIZE = 12;
+    const uint32_t MAX_PAYLOAD = 1 << 20;       // Larger frames are rejected and the connection closed
+
+    enum Opcode : uint8_t {
+        OP_GET = 1,
+        OP_POST = 2,
+        OP_DELETE = 3,
+        OP_BATCH_GET = 4
+    };
+
+    // Request flags
+    const uint8_t FLAG_TTL = 0x01;              // POST payload starts with a u32 TTL
+
+    // Fixed one-byte status codes, mirroring the text protocol's replies
+    enum Status : uint8_t {
+        STATUS_OK = 0,            // 200 Ok
+        STATUS_CREATED = 1,       // 201 Created
+        STATUS_NO_CONTENT = 2,    // 204 No Content
+        STATUS_BAD_REQUEST = 3,   // 400 Bad Request
+        STATUS_NOT_FOUND = 4      // 404 Not Found
+    };
+
+    // GET result, mirroring "false" / "true false" / "true true"
+    enum Verdict : uint8_t {
+        VERDICT_ABSENT = 0,           // Not in the Bloom filter
+        VERDICT_FALSE_POSITIVE = 1,   // In the Bloom filter but not blacklisted
+        VERDICT_BLACKLISTED = 2       // In the Bloom filter and blacklisted
+    };
+
+    // Decoded frame header (requests and responses share the layout)
+    struct Header {
+        uint8_t version;
+        uint8_t code;         // Opcode for requests, Status for responses
+        uint8_t flags;
+        uint32_t requestId;
+        uint32_t length;      // Payload length
+    };
+
+    /**
+     * Decodes a header from the first HEADER_SIZE bytes of data.
+     * @return false if the magic byte or version doesn't match.
+     */
+    bool decodeHeader(const char* data, Header& header);
+
+    /**
+     * Appends a full frame (header + payload) to out.
+     */
+    void appendFrame(std::string& out, uint8_t code, uint32_t requestId, const std::string& payload,
+                     uint8_t flags = 0);
+
+    /**
+     * Appends one (u16 length | URL) entry to a BATCH_GET payload.
+     */
+    void appendBatchUrl(std::string& payload, const std::string& url);
+
+    /**
+     * Splits a BATCH_GET payload into its URLs.
+     * @return false if the payload is truncated.
+     */
+    bool parseBatch(const std::string& payload, std::vector<std::string>& urls);
+
+    /**
+     * Appends a POST payload: the URL, prefixed with the TTL if it is nonzero
+     * (the frame must then carry FLAG_TTL).
+     */
+    void appendPost(std::string& payload, const std::string& url, uint32_t ttl);
+
+    /**
+     * Splits a POST payload into its URL and TTL (0 without FLAG_TTL).
+     * @return false if FLAG_TTL is set but the payload is too short.
+     */
+    bool parsePost(const Header& header, const std::string& payload, std::string& url, uint32_t& ttl);
+}
+
+#endif // BINARY_PROTOCOL_H
@@ -1,6 +1,25 @@
 #include "CommandParser.h"             // Header for CommandParser class and CommandType enum
 #include "Bloom/InputValidator.h"     // Includes parseCommandLine() for validating and splitting input
-#include <sstream>                    // Included in case string stream operations are needed
+#include "Analytics/HotKeys.h"        // Stream names accepted by TOPK
+#include "Bloom/Namespaces.h"         // Namespace limit for multi-namespace GET
+#include "Scan/UrlScanner.h"          // SCAN body size limit
+#include <algorithm>                  // For std::find
+#include <sstream>                    // For splitting commands that take no URL
+
+namespace {
+
+// Splits "a,b,c" into distinct valid namespace names
+bool splitNamespaces(const std::string& list, std::vector<std::string>& names) {
+    std::istringstream iss(list);
+    std::string name;
+    while (std::getline(iss, name, ',')) {
+        if (!isValidNamespace(name) || std::find(names.begin(), names.end(), name) != names.end()) return false;
+        names.push_back(name);
+    }
+    return !names.empty() && names.size() <= Namespaces::MAX_NAMESPACES && list.back() != ',';
+}
+
+} // namespace
 
 // Parses a string input command from the client and returns a ParsedCommand struct.
 // It uses parseCommandLine to extract the command type and URL, and maps the command string
@@ -8,6 +27,112 @@
 ParsedCommand CommandParser::parseCommand(const std::string& input) {
     std::string commandStr, url;  // To hold parsed command keyword (e.g., POST) and URL
 
+    // Commands that don't take a URL are handled before the URL-based parser
+    std::istringstream iss(input);
+    std::string keyword, arg, extra;
+    iss >> keyword;
+
+    // GET, POST, DELETE, SNAPSHOT, DIFF and SCAN may name a namespace right after the keyword.
+    // Names never contain a dot and URLs always do, so the two can't be confused.
+    // GET also takes a comma-separated list, checking the URL in each namespace.
+    if (keyword == "GET" || keyword == "POST" || keyword == "DELETE" || keyword == "SNAPSHOT" || keyword == "DIFF" ||
+        keyword == "SCAN") {
+        std::istringstream peek(input);
+        std::string ns, rest;
+        std::vector<std::string> names;
+        if ((peek >> keyword >> ns) && splitNamespaces(ns, names)) {
+            std::getline(peek, rest);
+            ParsedCommand parsed = parseCommand(keyword + rest);
+            if (parsed.type == CommandType::INVALID || parsed.type == CommandType::MULTI_GET || !parsed.ns.empty()) {
+                return {CommandType::INVALID, ""};
+            }
+            if (names.size() == 1) {
+                parsed.ns = names[0];
+                return parsed;
+            }
+            if (parsed.type != CommandType::GET) return {CommandType::INVALID, ""};
+            return {CommandType::MULTI_GET, parsed.url, names};
+        }
+    }
+
+    if (keyword == "CREATE") {
+        // CREATE takes a new namespace name, then a size and hash depths like the server's own arguments
+        std::string config;
+        size_t size;
+        std::vector<int> depths;
+        if (!(iss >> arg) || !isValidNamespace(arg) || !std::getline(iss, config) ||
+            !parseInitialConfig(config, size, depths)) {
+            return {CommandType::INVALID, ""};
+        }
+        std::vector<std::string> args{arg, std::to_string(size)};
+        for (int depth : depths) args.push_back(std::to_string(depth));
+        return {CommandType::CREATE, "", args};
+    }
+
+    if (keyword == "NAMESPACES") {
+        if (iss >> extra) return {CommandType::INVALID, ""};   // NAMESPACES takes no arguments
+        return {CommandType::NAMESPACES, ""};
+    }
+
+    if (keyword == "MEMORY") {
+        if (iss >> extra) return {CommandType::INVALID, ""};   // MEMORY takes no arguments
+        return {CommandType::MEMORY, ""};
+    }
+
+    if (keyword == "SNAPSHOT") {
+        if (iss >> extra) return {CommandType::INVALID, ""};   // SNAPSHOT takes no arguments
+        return {CommandType::SNAPSHOT, ""};
+    }
+
+    if (keyword == "STATS") {
+        if (iss >> extra) return {CommandType::INVALID, ""};   // STATS takes no arguments
+        return {CommandType::STATS, ""};
+    }
+
+    if (keyword == "TRACE") {
+        // TRACE takes exactly one argument: DUMP
+        if (!(iss >> arg) || arg != "DUMP" || (iss >> extra)) return {CommandType::INVALID, ""};
+        return {CommandType::TRACE_DUMP, ""};
+    }
+
+    if (keyword == "TOPK") {
+        // TOPK takes a stream name and an optional count (default 10, at most HotKeys::TOP_K)
+        HotKeys::Stream stream;
+        std::string count = "10";
+        if (!(iss >> arg) || !HotKeys::streamByName(arg, stream)) return {CommandType::INVALID, ""};
+        if (iss >> count) {
+            if ((iss >> extra) || count.size() > 2 || count.find_first_not_of("0123456789") != std::string::npos ||
+                std::stoul(count) == 0 || std::stoul(count) > HotKeys::TOP_K) {
+                return {CommandType::INVALID, ""};
+            }
+        }
+        return {CommandType::TOPK, "", {arg, count}};
+    }
+
+    if (keyword == "DIFF") {
+        // DIFF takes exactly one argument: the version the client already holds
+        if (!(iss >> arg) || (iss >> extra) || !isValidVersion(arg)) return {CommandType::INVALID, ""};
+        return {CommandType::DIFF, "", {arg}};
+    }
+
+    if (keyword == "SCAN") {
+        // SCAN takes the length in bytes of the body that follows the line
+        if (!(iss >> arg) || (iss >> extra) || arg.size() > 9 ||
+            arg.find_first_not_of("0123456789") != std::string::npos || std::stoul(arg) > UrlScanner::MAX_BODY) {
+            return {CommandType::INVALID, ""};
+        }
+        return {CommandType::SCAN, "", {arg}};
+    }
+
+    if (keyword == "POST") {
+        // POST takes an optional TTL in seconds after the URL
+        std::string ttl;
+        if ((iss >> arg) && (iss >> ttl)) {
+            if ((iss >> extra) || !isValidUrl(arg) || !isValidTtl(ttl)) return {CommandType::INVALID, ""};
+            return {CommandType::POST, arg, {ttl}};
+        }
+    }
+
     // Try to parse and validate the input string into commandStr and url
     if (!parseCommandLine(input, commandStr, url)) {
         return {CommandType::INVALID, ""};  // If parsing fails, return INVALID command
@@ -2,6 +2,7 @@
 #define COMMAND_PARSER_H
 
 #include <string>  // Required for std::string
+#include <vector>  // Required for std::vector
 
 // Enum representing the types of supported commands.
 // Used to dispatch to the correct logic later in the program.
@@ -9,14 +10,27 @@ enum class CommandType {
     POST,        // Add a URL to the Bloom filter and blacklist
     GET,         // Check if a URL is blacklisted
     DELETE_CMD,  // Remove a URL from the blacklist (not from the Bloom filter itself)
+    SNAPSHOT,    // Return the full bit array for a client-side copy
+    DIFF,        // Return the bit array words changed since a given version
+    STATS,       // Return the server's connection counters
+    TRACE_DUMP,  // Return the recent request spans as Chrome trace JSON
+    TOPK,        // Return the most frequent keys of a heavy-hitter stream
+    CREATE,      // Create a named filter with its own size and hash depths
+    NAMESPACES,  // List the named filters with their counters
+    MEMORY,      // Report memory use by component, with fill ratios and estimated false positive rates
+    MULTI_GET,   // Check a URL against several namespaces at once
+    SCAN,        // Check every URL in a text body that follows the command line
     INVALID      // Command could not be parsed or is not recognized
 };
 
 // Struct to represent the result of parsing a command string.
-// Holds both the command type and the URL associated with it.
+// Holds the command type, the URL associated with it, any further arguments,
+// and the namespace it applies to.
 struct ParsedCommand {
-    CommandType type;     // Type of the command (POST, GET, DELETE, etc.)
-    std::string url;      // The URL on which the command should operate
+    CommandType type;                    // Type of the command (POST, GET, DELETE, etc.)
+    std::string url;                     // The URL on which the command should operate
+    std::vector<std::string> args = {};  // Extra arguments (e.g., the version for DIFF)
+    std::string ns = {};                 // Target namespace; empty for the default one
 };
 
 // CommandParser is responsible for parsing raw input strings
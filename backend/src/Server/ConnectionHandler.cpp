@@ -1,8 +1,17 @@
 #include "ConnectionHandler.h"         // Header for ConnectionHandler class
-#include "Bloom/BloomFilter.h"         // Bloom filter logic
-#include "Bloom/InputValidator.h"      // Input validation utilities (e.g., parseInitialConfig)
+#include "Bloom/Namespaces.h"          // Named Bloom filters
+#include "Bloom/InputValidator.h"      // Input validation utilities (e.g., isValidUrl)
 #include "CommandParser.h"             // Parses client command strings into ParsedCommand
 #include "Commands/CommandFactory.h"   // Factory to create ICommand objects based on command type
+#include "Commands/GetCommand.h"       // GET responses answered from the verdict cache
+#include "Commands/ScanCommand.h"      // Checks the URLs found in a SCAN body
+#include "BinaryProtocol.h"            // Framing for binary clients
+#include "ServerStats.h"               // Timeout and oversized request counters
+#include "MemoryStats.h"               // Accounting for the receive buffer
+#include "Lifecycle.h"                 // Closing idle connections when draining
+#include "Trace/Trace.h"               // Per-phase request spans
+#include "Trace/Capture.h"             // Traffic recording for replay
+#include "Analytics/HotKeys.h"         // Heavy-hitter counts for TOPK
 
 #include <unistd.h>                    // For close()
 #include <sstream>                     // For string stream manipulation
@@ -11,91 +20,487 @@
 #include <sys/socket.h>                // For socket communication functions
 #include <thread>
 #include <mutex>
+#include <chrono>
+#include <algorithm>                   // For std::max, std::min
+#include <cerrno>
+#include <cctype>                      // For std::isspace
+#include <poll.h>                      // For poll()
+
+namespace {
+
+// Takes the filter mutex, recording how long the request waited for it
+std::unique_lock<std::mutex> lockFilter(std::mutex* bloom_mutex, const char* op) {
+    uint64_t start = Trace::now();
+    std::unique_lock<std::mutex> lock(*bloom_mutex);
+    Trace::record(Trace::LOCK_WAIT, op, start, Trace::now());
+    return lock;
+}
+
+// Trace label of a parsed text command
+const char* commandName(CommandType type) {
+    switch (type) {
+        case CommandType::POST: return "POST";
+        case CommandType::GET: return "GET";
+        case CommandType::DELETE_CMD: return "DELETE";
+        case CommandType::SNAPSHOT: return "SNAPSHOT";
+        case CommandType::DIFF: return "DIFF";
+        case CommandType::STATS: return "STATS";
+        case CommandType::TRACE_DUMP: return "TRACE DUMP";
+        case CommandType::TOPK: return "TOPK";
+        case CommandType::CREATE: return "CREATE";
+        case CommandType::NAMESPACES: return "NAMESPACES";
+        case CommandType::MEMORY: return "MEMORY";
+        case CommandType::MULTI_GET: return "MULTI GET";
+        case CommandType::SCAN: return "SCAN";
+        default: return "INVALID";
+    }
+}
+
+// Feeds a finished text command to the TOPK counters, after the filter lock is released
+void recordHotKeys(const ParsedCommand& parsed, const std::string& response) {
+    static const std::string falsePositive = "true false";
+    if (parsed.type == CommandType::GET) {
+        bool fp = response.size() >= falsePositive.size() &&
+                  response.compare(response.size() - falsePositive.size(), std::string::npos, falsePositive) == 0;
+        HotKeys::instance().recordGet(parsed.url, fp);
+    } else if (parsed.type == CommandType::POST && response.compare(0, 3, "201") == 0) {
+        HotKeys::instance().recordPost(parsed.url);
+    }
+}
+
+// Answers a GET from the namespace's verdict cache, without the filter mutex
+bool cachedVerdict(Namespaces::Namespace* ns, const std::string& url, VerdictCache::Verdict& verdict) {
+    if (!ns || !ns->cache || !ns->cache->lookup(url, *ns->filter, verdict)) return false;
+    ns->recordGet(verdict != VerdictCache::ABSENT, verdict == VerdictCache::BLACKLISTED);
+    return true;
+}
+
+// Counts a GET answered by the filter and caches its verdict. The caller holds the filter mutex.
+void recordVerdict(Namespaces::Namespace& ns, const std::string& url, bool positive, bool blacklisted) {
+    ns.recordGet(positive, blacklisted);
+    if (ns.cache) {
+        ns.cache->insert(url, !positive ? VerdictCache::ABSENT
+                              : blacklisted ? VerdictCache::BLACKLISTED : VerdictCache::FALSE_POSITIVE, *ns.filter);
+    }
+}
+
+// Counts a POST or DELETE that changed the URL, and drops its cached verdict.
+// The caller holds the filter mutex.
+void recordWrite(Namespaces::Namespace& ns, std::atomic<uint64_t>& counter, const std::string& url) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    if (ns.cache) ns.cache->invalidate(url);
+}
+
+// Updates the namespace's counters and verdict cache after a GET, POST or DELETE.
+// The caller holds the filter mutex.
+void afterCommand(Namespaces::Namespace& ns, const ParsedCommand& parsed, const std::string& response) {
+    static const std::string blacklisted = "true true";
+    static const std::string falsePositive = "true false";
+    auto endsWith = [&response](const std::string& tail) {
+        return response.size() >= tail.size() &&
+               response.compare(response.size() - tail.size(), std::string::npos, tail) == 0;
+    };
+
+    if (parsed.type == CommandType::GET && response.compare(0, 3, "200") == 0) {
+        bool isBlacklisted = endsWith(blacklisted);
+        recordVerdict(ns, parsed.url, isBlacklisted || endsWith(falsePositive), isBlacklisted);
+    } else if (parsed.type == CommandType::POST && response.compare(0, 3, "201") == 0) {
+        recordWrite(ns, ns.counters.posts, parsed.url);
+    } else if (parsed.type == CommandType::DELETE_CMD && response.compare(0, 3, "204") == 0) {
+        recordWrite(ns, ns.counters.deletes, parsed.url);
+    }
+}
+
+// Trims leading and trailing whitespace in place
+void trim(std::string& line) {
+    line.erase(0, line.find_first_not_of(" \t\r\n"));
+    size_t end = line.find_last_not_of(" \t\r\n");
+    if (end != std::string::npos) {
+        line.erase(end + 1);
+    } else {
+        line.clear();  // If line is all whitespace, just clear it
+    }
+}
+
+// Runs a command on its namespace's BloomFilter under the filter lock
+std::string executeLocked(ICommand& cmd, const ParsedCommand& parsed, Namespaces* namespaces,
+                          std::mutex* bloom_mutex, const char* op) {
+    auto lock = lockFilter(bloom_mutex, op);
+    Trace::Scope span(Trace::EXECUTE, op);
+    Namespaces::Namespace* target = namespaces->find(parsed.ns);
+    if (!target) return "404 Not Found";
+
+    target->filter->expire();  // Drop URLs whose TTL has passed before answering
+    std::string response = cmd.execute(*target->filter);
+    afterCommand(*target, parsed, response);
+    return response;
+}
+
+// Binary protocol code of a verdict
+char binaryCode(VerdictCache::Verdict verdict) {
+    switch (verdict) {
+        case VerdictCache::BLACKLISTED: return BinaryProtocol::VERDICT_BLACKLISTED;
+        case VerdictCache::FALSE_POSITIVE: return BinaryProtocol::VERDICT_FALSE_POSITIVE;
+        default: return BinaryProtocol::VERDICT_ABSENT;
+    }
+}
+
+// Runs one GET against the default namespace and maps the result to a binary verdict.
+// The caller holds the filter mutex.
+char binaryVerdict(Namespaces::Namespace* ns, const std::string& url) {
+    BloomFilter* bloom = ns->filter.get();
+    bloom->expire();
+    bool positive = bloom->check(url);
+    bool blacklisted = positive && bloom->doubleCheck(url);
+    recordVerdict(*ns, url, positive, blacklisted);
+    if (!positive) return BinaryProtocol::VERDICT_ABSENT;
+    return blacklisted ? BinaryProtocol::VERDICT_BLACKLISTED : BinaryProtocol::VERDICT_FALSE_POSITIVE;
+}
+
+// Executes one binary request and appends its response frame.
+// Goes to the filter directly: no parsing, regex or text formatting on the GET path.
+void executeFrame(const BinaryProtocol::Header& header, const std::string& payload,
+                  std::string& out, Namespaces* namespaces, std::mutex* bloom_mutex) {
+    using namespace BinaryProtocol;
+    uint8_t status = STATUS_BAD_REQUEST;
+    std::string body;
+    Namespaces::Namespace* ns = namespaces->primary();
+    BloomFilter* bloom = ns->filter.get();
+
+    switch (header.code) {
+        case OP_GET: {
+            if (payload.empty()) break;
+            VerdictCache::Verdict cached;
+            if (cachedVerdict(ns, payload, cached)) {
+                body += binaryCode(cached);
+            } else {
+                auto lock = lockFilter(bloom_mutex, "bin GET");
+                Trace::Scope span(Trace::EXECUTE, "bin GET", payload.size());
+                body += binaryVerdict(ns, payload);
+            }
+            HotKeys::instance().recordGet(payload, body[0] == VERDICT_FALSE_POSITIVE);
+            status = STATUS_OK;
+            break;
+        }
+
+        case OP_BATCH_GET: {
+            std::vector<std::string> urls;
+            if (!parseBatch(payload, urls)) break;
+            body.resize(urls.size());
+
+            // Cached verdicts first; the rest share one lock
+            std::vector<size_t> misses;
+            for (size_t i = 0; i < urls.size(); ++i) {
+                VerdictCache::Verdict cached;
+                if (cachedVerdict(ns, urls[i], cached)) body[i] = binaryCode(cached);
+                else misses.push_back(i);
+            }
+            if (!misses.empty()) {
+                auto lock = lockFilter(bloom_mutex, "bin BATCH_GET");
+                Trace::Scope span(Trace::EXECUTE, "bin BATCH_GET", payload.size());
+                for (size_t i : misses) body[i] = binaryVerdict(ns, urls[i]);
+            }
+            for (size_t i = 0; i < urls.size(); ++i) {
+                HotKeys::instance().recordGet(urls[i], body[i] == VERDICT_FALSE_POSITIVE);
+            }
+            status = STATUS_OK;
+            break;
+        }
+
+        case OP_POST: {
+            // Only URLs the text protocol would accept may enter the blacklist.
+            // GET and DELETE skip the regex: an invalid URL can never have been added.
+            std::string url;
+            uint32_t ttl;
+            if (!parsePost(header, payload, url, ttl) || !isValidUrl(url)) break;
+            {
+                auto lock = lockFilter(bloom_mutex, "bin POST");
+                Trace::Scope span(Trace::EXECUTE, "bin POST", payload.size());
+                bloom->add(url, ttl);
+                recordWrite(*ns, ns->counters.posts, url);
+            }
+            HotKeys::instance().recordPost(url);
+            status = STATUS_CREATED;
+            break;
+        }
+
+        case OP_DELETE:
+            if (payload.empty()) break;
+            {
+                auto lock = lockFilter(bloom_mutex, "bin DELETE");
+                Trace::Scope span(Trace::EXECUTE, "bin DELETE", payload.size());
+                bloom->expire();
+                status = bloom->remove(payload) ? STATUS_NO_CONTENT : STATUS_NOT_FOUND;
+                if (status == STATUS_NO_CONTENT) recordWrite(*ns, ns->counters.deletes, payload);
+            }
+            break;
+
+        default:
+            break;  // Unknown opcode
+    }
+
+    appendFrame(out, status, header.requestId, body);
+}
+
+// Sends the whole buffer, ignoring SIGPIPE if the client already left
+bool sendAll(int socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
 
 // Constructor initializes the ConnectionHandler with a client socket and configuration string
-ConnectionHandler::ConnectionHandler(int socket, BloomFilter* bloom, std::mutex* mutex)
-    : clientSocket(socket), bloom(bloom), bloom_mutex(mutex) {}
+ConnectionHandler::ConnectionHandler(int socket, Namespaces* namespaces, std::mutex* mutex, const ServerOptions& options)
+    : clientSocket(socket), namespaces(namespaces), bloom_mutex(mutex), options(options) {}
+
+// Parses and executes a single command line, returning the response to send.
+// Shared by every I/O backend so they all answer identically.
+std::string ConnectionHandler::processLine(std::string line, Namespaces* namespaces, std::mutex* bloom_mutex) {
+    std::string response = executeLine(line, namespaces, bloom_mutex);
+    if (Capture::enabled()) {
+        Capture::record(Capture::TEXT, line.data(), line.size(), response.data(), response.size());
+    }
+    return response;
+}
+
+// Trims the line in place, then parses and executes it.
+// The trimmed line is what the capture records.
+std::string ConnectionHandler::executeLine(std::string& line, Namespaces* namespaces, std::mutex* bloom_mutex) {
+    trim(line);
+
+    // Reject empty lines
+    if (line.empty()) {
+        return "400 Bad Request\n";
+    }
+
+    // Parse the command string using the CommandParser
+    uint64_t parseStart = Trace::now();
+    ParsedCommand parsed = CommandParser::parseCommand(line);
+    const char* op = commandName(parsed.type);
+    if (parsed.type == CommandType::INVALID) {
+        Trace::record(Trace::PARSE, op, parseStart, Trace::now(), line.size());
+        return "400 Bad Request\n";
+    }
+
+    // Create the appropriate command object based on the command type
+    std::unique_ptr<ICommand> cmd = CommandFactory::create(parsed, *namespaces);
+    Trace::record(Trace::PARSE, op, parseStart, Trace::now(), line.size());
+    if (!cmd) {
+        return "400 Bad Request\n";
+    }
+
+    // A GET whose verdict is cached is answered without the filter lock
+    if (parsed.type == CommandType::GET) {
+        VerdictCache::Verdict cached;
+        bool hit;
+        {
+            Trace::Scope span(Trace::EXECUTE, "GET cached");
+            hit = cachedVerdict(namespaces->find(parsed.ns), parsed.url, cached);
+        }
+        if (hit) {
+            std::string response = GetCommand::format(cached != VerdictCache::ABSENT, cached == VerdictCache::BLACKLISTED);
+            recordHotKeys(parsed, response);
+            return response + "\n";
+        }
+    }
+
+    // Execute the command on the namespace's BloomFilter
+    std::string response = executeLocked(*cmd, parsed, namespaces, bloom_mutex, op);
+    recordHotKeys(parsed, response);
+    return response + "\n";
+}
+
+bool ConnectionHandler::isScanLine(const std::string& line) {
+    size_t first = line.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos || line.compare(first, 4, "SCAN") != 0) return false;
+    return first + 4 == line.size() || std::isspace(static_cast<unsigned char>(line[first + 4]));
+}
+
+// Recognizes a valid SCAN line; anything else is left to processLine()
+std::unique_ptr<ConnectionHandler::PendingScan> ConnectionHandler::startScan(const std::string& line) {
+    if (!isScanLine(line)) return nullptr;
+
+    std::string trimmed = line;
+    trim(trimmed);
+    ParsedCommand parsed = CommandParser::parseCommand(trimmed);
+    if (parsed.type != CommandType::SCAN) return nullptr;
+
+    auto scan = std::make_unique<PendingScan>();
+    scan->line = trimmed;
+    scan->ns = parsed.ns;
+    scan->remaining = std::stoul(parsed.args.at(0));
+    return scan;
+}
+
+// Scans the body as it arrives, so a large mail is never held in memory whole
+bool ConnectionHandler::feedScan(PendingScan& scan, std::string& in, std::string& response,
+                                 Namespaces* namespaces, std::mutex* bloom_mutex) {
+    size_t take = std::min(scan.remaining, in.size());
+    if (take > 0) {
+        Trace::Scope span(Trace::PARSE, "SCAN", static_cast<uint32_t>(take));
+        scan.scanner.feed(in.data(), take);
+        if (Capture::enabled()) scan.body.append(in, 0, take);
+        in.erase(0, take);
+        scan.remaining -= take;
+    }
+    if (scan.remaining > 0) return false;
+    if (!in.empty() && in[0] == '\n') in.erase(0, 1);
+
+    scan.scanner.finish();
+    ScanCommand cmd(scan.scanner.urls());
+    response = executeLocked(cmd, {CommandType::SCAN, "", {}, scan.ns}, namespaces, bloom_mutex, "SCAN") + "\n";
+    if (Capture::enabled()) {
+        std::string request = scan.line + "\n" + scan.body;
+        Capture::record(Capture::TEXT, request.data(), request.size(), response.data(), response.size());
+    }
+    return true;
+}
+
+// Executes every complete binary frame at the start of `in`, appending the
+// response frames to `out`. Consumed bytes are removed from `in`; a partial
+// frame is left for the next read. Returns false on a malformed header, after
+// which the connection must be closed (the stream can't be resynchronized).
+bool ConnectionHandler::processFrames(std::string& in, std::string& out, Namespaces* namespaces, std::mutex* bloom_mutex) {
+    using namespace BinaryProtocol;
+    size_t pos = 0;
+    bool ok = true;
+
+    while (in.size() - pos >= HEADER_SIZE) {
+        Header header;
+        if (!decodeHeader(in.data() + pos, header) || header.length > MAX_PAYLOAD) {
+            appendFrame(out, STATUS_BAD_REQUEST, 0, "");
+            ok = false;
+            break;
+        }
+        if (in.size() - pos - HEADER_SIZE < header.length) break;  // Payload not fully received yet
+
+        std::string payload = in.substr(pos + HEADER_SIZE, header.length);
+        size_t frameStart = pos;
+        size_t responseStart = out.size();
+        pos += HEADER_SIZE + header.length;
+        executeFrame(header, payload, out, namespaces, bloom_mutex);
+
+        if (Capture::enabled()) {
+            Capture::record(Capture::FRAME, in.data() + frameStart, pos - frameStart,
+                            out.data() + responseStart, out.size() - responseStart);
+        }
+    }
+
+    in.erase(0, pos);
+    return ok;
+}
 
 // Handles incoming client requests on the connected socket
 void ConnectionHandler::handle() {
     char buffer[4096];                        // Buffer to read data from the socket
     std::string leftover;                     // Stores any partial or extra input between reads
-    size_t size;                              // Bloom filter size
-    std::vector<int> config;                  // Hash function depths
-    //std::unique_ptr<BloomFilter> bloom;       // Bloom filter instance (managed with smart pointer)
-    
-    /*
-    // Parse the configuration passed to the handler (not from client input)
-    if (!parseInitialConfig(configLine, size, config)) {
-        std::string response = "400 Bad Request\n";
-        send(clientSocket, response.c_str(), response.size(), 0);
-        close(clientSocket);                  // Close connection on invalid config
-        return;
-    }
-
-    // Create BloomFilter with parsed parameters and data file for persistent state
-    bloom = std::make_unique<BloomFilter>(size, config, "data/filter_data.txt");*/
+    bool firstRead = true;
+    bool binary = false;                      // Client speaks the binary protocol
+    bool rejectedScan = false;                // A SCAN line was invalid; its body must not run as commands
+    std::unique_ptr<PendingScan> scan;        // SCAN whose body is still arriving
+    ServerStats& stats = ServerStats::instance();
+    MemoryCounter::Holding buffers(MemoryStats::instance().connectionBuffers);  // leftover's capacity
+    auto requestStart = std::chrono::steady_clock::now();  // When the buffered partial request began
 
     // Enter main communication loop with the client
     while (true) {
+        // Wait for data, but only as long as the idle timeout allows between requests,
+        // or what remains of the read timeout while a request is partly received
+        int timeout = options.idleTimeoutMs;
+        bool midRequest = !leftover.empty() || scan;
+        if (midRequest) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - requestStart).count();
+            timeout = static_cast<int>(std::max<long long>(0, options.readTimeoutMs - elapsed));
+        }
+        // Between requests, also wake up when the server starts draining. A new
+        // connection is left to send its first request, which is surely on its way.
+        pollfd ready[2] = {{clientSocket, POLLIN, 0}, {Lifecycle::drainFd(), POLLIN, 0}};
+        int polled = poll(ready, !firstRead && !midRequest ? 2 : 1, timeout);
+        if (polled < 0 && errno == EINTR) continue;
+        if (polled == 0) {
+            (midRequest ? stats.readTimeouts : stats.idleTimeouts).fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        if (polled < 0) break;
+        if (!ready[0].revents) break;  // Draining, and no request has started
+
         // Receive data from client into buffer (up to 4095 bytes)
+        uint64_t recvStart = Trace::now();
         ssize_t bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
         if (bytesReceived <= 0) break;        // Exit if client disconnected or error occurred
+        Trace::record(Trace::RECV, "conn", recvStart, Trace::now(), static_cast<uint32_t>(bytesReceived));
 
-        buffer[bytesReceived] = '\0';         // Null-terminate the received string
-        leftover += buffer;                   // Append new data to any leftover from previous reads
+        if (!midRequest) requestStart = std::chrono::steady_clock::now();
+        leftover.append(buffer, bytesReceived);  // Append new data to any leftover from previous reads
+        buffers.update(MemoryStats::heapBytes(leftover));  // Only grows: consumed lines don't shrink it
 
-        // Process full lines (commands are separated by '\n')
-        size_t pos;
-        while ((pos = leftover.find('\n')) != std::string::npos) {
-            std::string line = leftover.substr(0, pos);  // Extract full line
-            leftover.erase(0, pos + 1);                  // Remove the line from leftover buffer
+        // A binary client announces itself with the magic byte as its very first byte
+        if (firstRead) {
+            binary = static_cast<uint8_t>(leftover[0]) == BinaryProtocol::MAGIC;
+            firstRead = false;
+        }
 
-            // Trim leading whitespace
-            line.erase(0, line.find_first_not_of(" \t\r\n"));
+        // Binary connections stay open: answer every complete frame, keep reading
+        if (binary) {
+            std::string out;
+            bool ok = processFrames(leftover, out, namespaces, bloom_mutex);
+            if (!out.empty()) {
+                Trace::Scope span(Trace::SEND, "binary", static_cast<uint32_t>(out.size()));
+                if (!sendAll(clientSocket, out)) break;
+            }
+            if (!ok) break;
+            continue;
+        }
 
-            // Trim trailing whitespace
-            size_t end = line.find_last_not_of(" \t\r\n");
-            if (end != std::string::npos) {
-                line.erase(end + 1);
+        // Process full lines (commands are separated by '\n'); a SCAN line is followed by its body
+        while (true) {
+            std::string response;
+            if (scan) {
+                if (!feedScan(*scan, leftover, response, namespaces, bloom_mutex)) break;
+                scan.reset();
             } else {
-                line.clear();  // If line is all whitespace, just clear it
-            }
+                size_t pos = leftover.find('\n');
+                if (pos == std::string::npos) break;
+                std::string line = leftover.substr(0, pos);  // Extract full line
+                leftover.erase(0, pos + 1);                  // Remove the line from leftover buffer
 
-            // Reject empty lines
-            if (line.empty()) {
-                std::string response = "400 Bad Request\n";
-                send(clientSocket, response.c_str(), response.size(), 0);
-                shutdown(clientSocket, SHUT_WR);
-                continue;
+                if ((scan = startScan(line))) continue;
+                response = processLine(line, namespaces, bloom_mutex);
+                rejectedScan = isScanLine(line);
             }
 
-            // Parse the command string using the CommandParser
-            ParsedCommand parsed = CommandParser::parseCommand(line);
-            if (parsed.type == CommandType::INVALID) {
-                std::string response = "400 Bad Request\n";
-                send(clientSocket, response.c_str(), response.size(), 0);
-                shutdown(clientSocket, SHUT_WR);
-                continue;
+            // Send the response back to the client
+            {
+                Trace::Scope span(Trace::SEND, "text", static_cast<uint32_t>(response.size()));
+                sendAll(clientSocket, response);  // A second line after the shutdown must not raise SIGPIPE
             }
+            shutdown(clientSocket, SHUT_WR);
+            if (rejectedScan) break;
+        }
 
-            // Create the appropriate command object based on the command type
-            std::unique_ptr<ICommand> cmd = CommandFactory::create(parsed.type, parsed.url);
-            if (!cmd) {
-                std::string response = "400 Bad Request\n";
-                send(clientSocket, response.c_str(), response.size(), 0);
-                shutdown(clientSocket, SHUT_WR);
-                continue;
-            }
+        // The body of a rejected SCAN is dropped with the connection, unread
+        if (rejectedScan) {
+            while (recv(clientSocket, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {}
+            break;
+        }
 
-            // Execute the command on the BloomFilter and send the response back to the client
-            std::string response;
-            {
-                std::lock_guard<std::mutex> lock(*bloom_mutex);
-                response = cmd->execute(*bloom) + "\n";
-            }
-            send(clientSocket, response.c_str(), response.size(), 0);
+        // A partial line can't grow without bound
+        if (leftover.size() > static_cast<size_t>(options.maxLine)) {
+            stats.oversizedRequests.fetch_add(1, std::memory_order_relaxed);
+            sendAll(clientSocket, "400 Bad Request\n");
+
+            // Closing with unread input would reset the connection and could discard the
+            // reply, so discard what has already arrived first (without waiting for more)
             shutdown(clientSocket, SHUT_WR);
+            while (recv(clientSocket, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {}
+            break;
         }
     }
 
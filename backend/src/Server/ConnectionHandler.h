@@ -1,9 +1,12 @@
 #ifndef CONNECTION_HANDLER_H
 #define CONNECTION_HANDLER_H
 
+#include <memory>
 #include <mutex>
 #include <string>  // Required for std::string
-#include "Bloom/BloomFilter.h"
+#include "Bloom/Namespaces.h"
+#include "Scan/UrlScanner.h"
+#include "ServerOptions.h"
 
 // The ConnectionHandler class manages the lifecycle of a single client connection.
 // It handles receiving input, parsing commands, executing them, and sending responses back.
@@ -13,23 +16,94 @@ public:
      * @brief Constructor that initializes the connection handler with a socket and config line.
      * 
      * @param socket The connected client socket (already accepted by the server).
-     * @param configLine A configuration string used to initialize the BloomFilter (e.g., "256 1 2").
+     * @param namespaces The shared filters, by namespace.
+     * @param bloom_mutex Mutex guarding every namespace.
+     * @param options Timeouts and the maximum line length; must outlive the handler.
      */
-    ConnectionHandler(int socket, BloomFilter* bloom, std::mutex* bloom_mutex);
+    ConnectionHandler(int socket, Namespaces* namespaces, std::mutex* bloom_mutex, const ServerOptions& options);
 
     /**
      * @brief Starts handling the communication with the client.
      * 
      * This function listens for commands from the client, validates them,
      * executes the corresponding logic using a BloomFilter, and sends back responses.
+     * Closes the connection when the client is idle or sends a request too slowly
+     * (see ServerOptions), or sends a line longer than the maximum.
      */
     void handle();
 
+    /**
+     * @brief Parses and executes one command line (without its trailing '\n').
+     *
+     * @param line The raw line received from the client.
+     * @param namespaces The shared filters, by namespace.
+     * @param bloom_mutex Mutex guarding every namespace.
+     * @return The response to send back, including its trailing newline.
+     */
+    static std::string processLine(std::string line, Namespaces* namespaces, std::mutex* bloom_mutex);
+
+    /**
+     * @brief Executes the complete binary frames buffered in `in` (see BinaryProtocol.h).
+     *        Binary requests always use the default namespace.
+     *
+     * @param in Received bytes; consumed frames are removed, a partial frame is kept.
+     * @param out Output: response frames to send back.
+     * @param namespaces The shared filters, by namespace.
+     * @param bloom_mutex Mutex guarding every namespace.
+     * @return false if a malformed frame was found and the connection should be closed.
+     */
+    static bool processFrames(std::string& in, std::string& out, Namespaces* namespaces, std::mutex* bloom_mutex);
+
+    // A SCAN whose body is still arriving
+    struct PendingScan {
+        std::string line;         // The SCAN line, trimmed
+        std::string ns;           // Target namespace; empty for the default one
+        size_t remaining;         // Body bytes still to come
+        UrlScanner scanner;
+        std::string body;         // Only kept while capturing traffic
+    };
+
+    /**
+     * @brief Starts a SCAN if `line` is a valid "SCAN [<namespace>] <length>" line.
+     *        The backend then passes the bytes that follow to feedScan()
+     *        instead of splitting them into lines.
+     *
+     * @return nullptr for any other line, which goes to processLine() as usual.
+     */
+    static std::unique_ptr<PendingScan> startScan(const std::string& line);
+
+    /**
+     * @brief True if `line` starts with the SCAN keyword, valid or not. When
+     *        startScan() rejects such a line (e.g. the length is over
+     *        UrlScanner::MAX_BODY), the body the client sends next must not be
+     *        read as commands: the backends answer 400 and close the connection.
+     */
+    static bool isScanLine(const std::string& line);
+
+    /**
+     * @brief Feeds received bytes to a SCAN, up to the end of its body, plus one
+     *        newline right after the body if it has already arrived. Once the
+     *        body is complete, checks the URLs found and sets the response.
+     *
+     * @param scan The SCAN in progress.
+     * @param in Received bytes; those belonging to the body are removed.
+     * @param response Output: the response, with its trailing newline, once complete.
+     * @param namespaces The shared filters, by namespace.
+     * @param bloom_mutex Mutex guarding every namespace.
+     * @return true once the body is complete.
+     */
+    static bool feedScan(PendingScan& scan, std::string& in, std::string& response,
+                         Namespaces* namespaces, std::mutex* bloom_mutex);
+
 private:
+    // processLine() without the capture: trims `line` in place, then executes it
+    static std::string executeLine(std::string& line, Namespaces* namespaces, std::mutex* bloom_mutex);
+
     int clientSocket;         // Socket descriptor for the client connection
     std::string configLine;   // Configuration string for setting up the BloomFilter
-    BloomFilter* bloom;
+    Namespaces* namespaces;
     std::mutex* bloom_mutex;
+    const ServerOptions& options;
 };
 
 #endif // CONNECTION_HANDLER_H
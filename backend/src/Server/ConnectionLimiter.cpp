@@ -0,0 +1,112 @@
+#include "ConnectionLimiter.h"
+#include "ServerStats.h"
+
+#include <algorithm>                   // For std::min
+#include <arpa/inet.h>                 // For inet_ntop()
+#include <netinet/in.h>                // For sockaddr_in, sockaddr_in6
+#include <sys/socket.h>                // For getpeername(), SO_LINGER
+#include <unistd.h>                    // For close()
+
+namespace {
+
+// Past this many tracked addresses, idle ones with a full bucket are dropped
+const size_t SWEEP_THRESHOLD = 4096;
+
+} // namespace
+
+ConnectionLimiter::ConnectionLimiter(const ServerOptions& options)
+    : maxConnections(options.maxConnections), maxPerIp(options.maxPerIp),
+      ratePerIp(options.ratePerIp),
+      burstPerIp(options.burstPerIp > 0 ? options.burstPerIp : options.ratePerIp) {}
+
+// Adds the tokens earned since the last refill, up to the bucket size
+void ConnectionLimiter::refill(Client& client, Clock::time_point now) const {
+    double seconds = std::chrono::duration<double>(now - client.refilled).count();
+    client.tokens = std::min(burstPerIp, client.tokens + seconds * ratePerIp);
+    client.refilled = now;
+}
+
+// Forgets addresses with no open connection and a full bucket; they'd start over identically
+void ConnectionLimiter::sweep(Clock::time_point now) {
+    for (auto it = clients.begin(); it != clients.end();) {
+        if (ratePerIp > 0) refill(it->second, now);
+        bool full = ratePerIp == 0 || it->second.tokens >= burstPerIp;
+        if (it->second.active == 0 && full) it = clients.erase(it);
+        else ++it;
+    }
+}
+
+ConnectionLimiter::Verdict ConnectionLimiter::admit(const std::string& peer) {
+    ServerStats& stats = ServerStats::instance();
+    stats.accepted.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (maxConnections > 0 && active >= maxConnections) {
+        stats.shedCapacity.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::AT_CAPACITY;
+    }
+
+    if (!peer.empty() && (maxPerIp > 0 || ratePerIp > 0)) {
+        Clock::time_point now = Clock::now();
+        if (clients.size() >= SWEEP_THRESHOLD) sweep(now);
+
+        auto inserted = clients.try_emplace(peer);
+        Client& client = inserted.first->second;
+        if (inserted.second) {
+            client.tokens = burstPerIp;
+            client.refilled = now;
+        }
+
+        if (maxPerIp > 0 && client.active >= maxPerIp) {
+            stats.shedPerIp.fetch_add(1, std::memory_order_relaxed);
+            return Verdict::IP_LIMIT;
+        }
+        if (ratePerIp > 0) {
+            refill(client, now);
+            if (client.tokens < 1) {
+                stats.shedRate.fetch_add(1, std::memory_order_relaxed);
+                return Verdict::RATE_LIMIT;
+            }
+            client.tokens -= 1;
+        }
+        ++client.active;
+    }
+
+    ++active;
+    stats.active.fetch_add(1, std::memory_order_relaxed);
+    return Verdict::ADMIT;
+}
+
+void ConnectionLimiter::release(const std::string& peer) {
+    ServerStats::instance().active.fetch_sub(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    --active;
+    if (peer.empty()) return;
+
+    auto it = clients.find(peer);
+    if (it == clients.end()) return;
+    --it->second.active;
+    if (it->second.active == 0 && ratePerIp == 0) clients.erase(it);
+}
+
+std::string ConnectionLimiter::peerAddress(int socket) {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    if (getpeername(socket, reinterpret_cast<sockaddr*>(&addr), &len) < 0) return "";
+
+    char text[INET6_ADDRSTRLEN] = "";
+    if (addr.ss_family == AF_INET) {
+        inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(&addr)->sin_addr, text, sizeof(text));
+    } else if (addr.ss_family == AF_INET6) {
+        inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6*>(&addr)->sin6_addr, text, sizeof(text));
+    }
+    return text;
+}
+
+void ConnectionLimiter::reject(int socket) {
+    // Zero linger turns close() into a reset: no FIN handshake, no TIME_WAIT
+    linger reset{1, 0};
+    setsockopt(socket, SOL_SOCKET, SO_LINGER, &reset, sizeof(reset));
+    close(socket);
+}
@@ -0,0 +1,76 @@
+#ifndef CONNECTION_LIMITER_H
+#define CONNECTION_LIMITER_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "ServerOptions.h"
+
+/**
+ * @brief Admission control for new connections, shared by every acceptor.
+ *
+ * Enforces the global connection cap and, per client IP address, a cap on
+ * concurrent connections and a token bucket on new connections per second.
+ * Unix domain clients have no address and only count toward the global cap.
+ * Rejected sockets are reset straight away, so a flood costs no thread or
+ * buffer. Each outcome is counted in ServerStats.
+ */
+class ConnectionLimiter {
+public:
+    enum class Verdict {
+        ADMIT,
+        AT_CAPACITY,   // --max-connections reached
+        IP_LIMIT,      // --max-per-ip reached for this address
+        RATE_LIMIT     // This address's token bucket is empty
+    };
+
+    explicit ConnectionLimiter(const ServerOptions& options);
+
+    /**
+     * @brief Decides whether to serve a newly accepted connection.
+     *        An admitted connection must be released when it closes.
+     *
+     * @param peer The client's IP address, or empty for Unix domain clients.
+     */
+    Verdict admit(const std::string& peer);
+
+    /**
+     * @brief Records that an admitted connection has closed.
+     */
+    void release(const std::string& peer);
+
+    /**
+     * @brief The IP address of a connected socket's peer, or empty if it has none.
+     */
+    static std::string peerAddress(int socket);
+
+    /**
+     * @brief Closes a rejected socket with a reset instead of a graceful close.
+     */
+    static void reject(int socket);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Per-address state; dropped once idle with a full bucket
+    struct Client {
+        int active = 0;
+        double tokens = 0;
+        Clock::time_point refilled;
+    };
+
+    int maxConnections;   // 0: unlimited
+    int maxPerIp;         // 0: unlimited
+    double ratePerIp;     // Tokens per second; 0: unlimited
+    double burstPerIp;    // Bucket size
+
+    std::mutex mutex;
+    int active = 0;
+    std::unordered_map<std::string, Client> clients;
+
+    void refill(Client& client, Clock::time_point now) const;
+    void sweep(Clock::time_point now);
+};
+
+#endif // CONNECTION_LIMITER_H
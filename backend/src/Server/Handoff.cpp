@@ -0,0 +1,120 @@
+#include "Handoff.h"
+
+#include <algorithm>                   // For std::min
+#include <cstring>                     // For std::memcpy, std::strncpy
+#include <sys/socket.h>                // For sendmsg(), recvmsg(), SCM_RIGHTS
+#include <sys/un.h>                    // For sockaddr_un
+#include <unistd.h>                    // For close(), unlink()
+
+namespace Handoff {
+
+namespace {
+
+// Message types; SOCK_SEQPACKET keeps each one, with its descriptors, separate
+const char FDS = 'F';                  // Carries a group of listening sockets
+const char END = 'E';                  // Every listener has been sent
+const char READY = 'R';                // The final snapshot is on disk
+
+const size_t FDS_PER_MESSAGE = 64;     // Well under the kernel's SCM_MAX_FD
+
+bool fillAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return true;
+}
+
+bool sendMessage(int socket, char type, const int* fds, size_t count) {
+    char data = type;
+    iovec iov{&data, 1};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * FDS_PER_MESSAGE)];
+    if (count > 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+        std::memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+    }
+    return sendmsg(socket, &msg, MSG_NOSIGNAL) == 1;
+}
+
+} // namespace
+
+int listen(const std::string& path) {
+    sockaddr_un addr;
+    if (!fillAddress(path, addr)) return -1;
+
+    int socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socket < 0) return -1;
+
+    // The previous server's socket may still exist; it has already been used
+    unlink(path.c_str());
+    if (bind(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(socket, 1) < 0) {
+        close(socket);
+        return -1;
+    }
+    return socket;
+}
+
+bool takeOver(const std::string& path, std::vector<int>& listeners) {
+    sockaddr_un addr;
+    if (!fillAddress(path, addr)) return false;
+
+    int socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socket < 0) return false;
+    if (connect(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(socket);  // Nobody is serving there: start normally
+        return false;
+    }
+
+    // Collect descriptors until END, then wait for READY. If the old server
+    // dies first, the inherited sockets and the files on disk are still usable.
+    while (true) {
+        char type = 0;
+        iovec iov{&type, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * FDS_PER_MESSAGE)];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t n = recvmsg(socket, &msg, MSG_CMSG_CLOEXEC);
+        if (n <= 0 || type == READY) break;
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const unsigned char* data = CMSG_DATA(cmsg);
+            for (size_t i = 0; i < count; ++i) {
+                int fd;
+                std::memcpy(&fd, data + i * sizeof(int), sizeof(int));
+                listeners.push_back(fd);
+            }
+        }
+    }
+
+    close(socket);
+    return !listeners.empty();
+}
+
+bool sendListeners(int successor, const std::vector<int>& listeners) {
+    for (size_t i = 0; i < listeners.size(); i += FDS_PER_MESSAGE) {
+        size_t count = std::min(FDS_PER_MESSAGE, listeners.size() - i);
+        if (!sendMessage(successor, FDS, listeners.data() + i, count)) return false;
+    }
+    return sendMessage(successor, END, nullptr, 0);
+}
+
+void signalReady(int successor) {
+    sendMessage(successor, READY, nullptr, 0);
+}
+
+} // namespace Handoff
@@ -0,0 +1,46 @@
+#ifndef HANDOFF_H
+#define HANDOFF_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Passing the listening sockets from a running server to its replacement.
+ *
+ * The running server listens on a Unix socket (--handoff=PATH). A new server
+ * started with the same path connects to it, receives duplicates of every
+ * listening socket (SCM_RIGHTS), and waits. The old server stops accepting,
+ * drains, writes its final snapshot and then reports ready, and the new one
+ * loads that snapshot and starts accepting on the same sockets. Connections
+ * arriving in between wait in the listen backlog instead of being refused.
+ */
+namespace Handoff {
+
+    /**
+     * @brief Listens for a successor on `path`, replacing any stale socket file.
+     * @return The listening socket, or -1 on failure.
+     */
+    int listen(const std::string& path);
+
+    /**
+     * @brief Takes over from the server listening on `path`, if there is one.
+     *
+     * Blocks until the old server has written its final snapshot (or exited).
+     *
+     * @param listeners Output: the inherited listening sockets.
+     * @return false if no server answered on `path`.
+     */
+    bool takeOver(const std::string& path, std::vector<int>& listeners);
+
+    /**
+     * @brief Sends the listening sockets to a connected successor.
+     */
+    bool sendListeners(int successor, const std::vector<int>& listeners);
+
+    /**
+     * @brief Tells the successor the final snapshot is written.
+     */
+    void signalReady(int successor);
+}
+
+#endif // HANDOFF_H
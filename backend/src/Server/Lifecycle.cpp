@@ -0,0 +1,45 @@
+#include "Lifecycle.h"
+#include "ServerStats.h"               // Active connection count
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <sys/eventfd.h>               // For eventfd()
+#include <unistd.h>                    // For write()
+
+namespace Lifecycle {
+
+namespace {
+
+std::atomic<bool> started{false};
+
+} // namespace
+
+int drainFd() {
+    static const int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    return fd;
+}
+
+void beginDrain() {
+    if (started.exchange(true)) return;
+
+    // Never read, so it stays readable for every poller
+    uint64_t one = 1;
+    if (write(drainFd(), &one, sizeof(one)) != sizeof(one)) {}
+}
+
+bool draining() {
+    return started.load(std::memory_order_relaxed);
+}
+
+bool waitForConnections(int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (ServerStats::instance().active.load(std::memory_order_relaxed) > 0) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace Lifecycle
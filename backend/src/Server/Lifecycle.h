@@ -0,0 +1,31 @@
+#ifndef LIFECYCLE_H
+#define LIFECYCLE_H
+
+/**
+ * @brief Process-wide shutdown state shared by every I/O backend.
+ *
+ * Once draining starts, acceptors stop taking connections and connections
+ * close as soon as they have no request in progress; requests already
+ * received are still answered. drainFd() becomes readable at that moment, so
+ * blocking loops can include it in poll() instead of waking up periodically.
+ */
+namespace Lifecycle {
+
+    // Starts draining; later calls have no effect
+    void beginDrain();
+
+    bool draining();
+
+    // eventfd that stays readable once draining has started
+    int drainFd();
+
+    /**
+     * @brief Waits until no connection is being served.
+     *
+     * @param timeoutMs Longest time to wait.
+     * @return false if connections were still open when the time ran out.
+     */
+    bool waitForConnections(int timeoutMs);
+}
+
+#endif // LIFECYCLE_H
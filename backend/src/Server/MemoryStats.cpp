@@ -0,0 +1,68 @@
+#include "MemoryStats.h"
+
+#include <fstream>
+#include <malloc.h>    // For mallinfo2()
+#include <pthread.h>   // For pthread_getattr_default_np()
+#include <unistd.h>    // For sysconf()
+
+namespace {
+
+// Resident pages of the process, from /proc/self/statm: "size resident shared ..."
+long long residentBytes() {
+    std::ifstream in("/proc/self/statm");
+    long long size = 0, resident = 0;
+    if (!(in >> size >> resident)) return 0;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+// Threads of the process, from the "Threads:" line of /proc/self/status
+long long threadCount() {
+    std::ifstream in("/proc/self/status");
+    std::string key;
+    long long value;
+    while (in >> key) {
+        if (key == "Threads:") return (in >> value) ? value : 0;
+        in.ignore(4096, '\n');
+    }
+    return 0;
+}
+
+// Stack size new threads get; reserved address space, only touched pages are resident
+long long defaultStackBytes() {
+    pthread_attr_t attr;
+    size_t size = 0;
+    if (pthread_getattr_default_np(&attr) != 0) return 0;
+    pthread_attr_getstacksize(&attr, &size);
+    pthread_attr_destroy(&attr);
+    return static_cast<long long>(size);
+}
+
+} // namespace
+
+MemoryStats& MemoryStats::instance() {
+    static MemoryStats stats;
+    return stats;
+}
+
+std::string MemoryStats::format() const {
+    std::string out = connectionBuffers.snapshot().format("connection_buffers");
+    auto line = [&out](const char* name, long long value) {
+        out += "\n";
+        out += name;
+        out += " ";
+        out += std::to_string(value);
+    };
+
+    line("rss_bytes", residentBytes());
+
+    // Heap: everything malloc got from the kernel, what it has handed out, and what sits free inside it
+    struct mallinfo2 heap = mallinfo2();
+    line("heap_mapped_bytes", static_cast<long long>(heap.arena + heap.hblkhd));
+    line("heap_in_use_bytes", static_cast<long long>(heap.uordblks + heap.hblkhd));
+    line("heap_free_bytes", static_cast<long long>(heap.fordblks));
+
+    long long threads = threadCount();
+    line("threads", threads);
+    line("thread_stacks_reserved_bytes", threads * defaultStackBytes());
+    return out;
+}
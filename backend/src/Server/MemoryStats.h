@@ -0,0 +1,40 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include "Bloom/MemoryCounter.h"   // Live bytes and allocations of a component
+
+#include <string>
+
+/**
+ * @brief Process-wide memory figures, reported by the MEMORY command after
+ *        the filters' own (see Namespaces::formatMemory()).
+ *
+ * Every backend accounts for its connections' receive and send buffers here,
+ * with a MemoryCounter::Holding per connection. The rest is read from the
+ * kernel and the C library when the report is made: resident memory, how
+ * much of the heap malloc holds in use or free (free heap that isn't
+ * returned is fragmentation), and the stacks reserved for threads.
+ */
+class MemoryStats {
+public:
+    static MemoryStats& instance();
+
+    MemoryCounter connectionBuffers;   // Buffers of open connections and the io_uring receive pool
+
+    /**
+     * @brief Formats the connection buffers and the process figures as
+     *        "name value" lines, joined by '\n'.
+     */
+    std::string format() const;
+
+    // Heap bytes behind a string: its capacity, unless it still fits in the string's inline buffer
+    static size_t heapBytes(const std::string& s) {
+        static const size_t inlineCapacity = std::string().capacity();
+        return s.capacity() > inlineCapacity ? s.capacity() : 0;
+    }
+
+private:
+    MemoryStats() = default;
+};
+
+#endif // MEMORY_STATS_H
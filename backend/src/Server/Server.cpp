@@ -1,27 +1,40 @@
 #include "Server.h"                // Include the Server class definition
 #include "ConnectionHandler.h"     // For handling individual client connections
-#include "Bloom/BloomFilter.h"
+#include "UringServer.h"           // Optional io_uring event loop
+#include "Lifecycle.h"             // Drain state shared with the connections
+#include "Handoff.h"               // Passing the listeners to a new server
+#include "Bloom/Namespaces.h"
+#include "ServerStats.h"           // Connections still open after the drain
+#include "Trace/Capture.h"         // Flushed before exiting
 
 #include <iostream>                // For std::cout and std::cerr
 #include <stdexcept>               // For throwing runtime errors
 #include <cstring>                 // For std::memset
 #include <sys/socket.h>            // For socket(), bind(), listen(), accept()
 #include <netinet/in.h>            // For sockaddr_in
+#include <sys/un.h>                // For sockaddr_un
 #include <unistd.h>                // For close()
+#include <fcntl.h>                 // For fcntl(), O_NONBLOCK
+#include <poll.h>                  // For poll()
+#include <csignal>                 // For SIGTERM
+#include <sys/signalfd.h>          // For signalfd()
+#include <cerrno>
 #include <thread>
 #include <mutex>
+#include <memory>
 
-#define MAX_CLIENTS 100            // Define the maximum number of clients to handle at once
 static std::mutex bloom_mutex;
 
 // Modified constructor: no IP argument
-Server::Server(int port, const std::string& configLine, BloomFilter* bloom, ThreadManager* manager)
-    : port(port), serverSocket(-1), configLine(configLine), bloom(bloom), threadManager(manager) {}
+Server::Server(int port, const std::string& configLine, Namespaces* namespaces, ThreadManager* manager,
+               const ServerOptions& options)
+    : port(port), configLine(configLine), namespaces(namespaces), threadManager(manager), options(options),
+      limiter(options) {}
 
-// Sets up the server socket, binds it to all available interfaces, and starts listening
-void Server::setupSocket() {
+// Creates a TCP socket bound to all available interfaces and starts listening
+int Server::createTcpListener(bool reusePort) {
     // Create a TCP socket (IPv4)
-    serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+    int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
     if (serverSocket < 0) {  // Check if socket creation failed
         perror("Error creating socket");
         throw std::runtime_error("Socket creation failed");
@@ -34,6 +47,12 @@ void Server::setupSocket() {
         exit(EXIT_FAILURE);  // If setting socket options failed, exit
     }
 
+    // Let several acceptors bind the same port; the kernel balances connections between them
+    if (reusePort && setsockopt(serverSocket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("setsockopt SO_REUSEPORT failed");
+        exit(EXIT_FAILURE);
+    }
+
     // Initialize sockaddr_in structure to specify server address details
     sockaddr_in serverAddr{};  // Zero-initialize the structure
     std::memset(&serverAddr, 0, sizeof(serverAddr));  // Explicitly set all fields to zero
@@ -48,42 +67,226 @@ void Server::setupSocket() {
     }
 
     // Start listening for incoming connections
-    if (listen(serverSocket, MAX_CLIENTS) < 0) {
+    if (listen(serverSocket, options.backlog) < 0) {
         perror("Error listening");  // If listening fails, print error
         close(serverSocket);  // Close the socket
         throw std::runtime_error("Listen failed");
     }
 
+    // Acceptors poll before accepting; another process sharing the socket may take the connection first
+    fcntl(serverSocket, F_SETFL, fcntl(serverSocket, F_GETFL) | O_NONBLOCK);
+    return serverSocket;
+}
+
+// Creates a Unix domain socket (stream or seqpacket) on the given path and starts listening
+int Server::createUnixListener(const std::string& path, int type) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Unix socket path too long");
+    }
+
+    int unixSocket = socket(AF_UNIX, type, 0);
+    if (unixSocket < 0) {
+        perror("Error creating Unix socket");
+        throw std::runtime_error("Socket creation failed");
+    }
+
+    // A stale socket file from a previous run would make bind() fail
+    unlink(path.c_str());
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (bind(unixSocket, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(unixSocket, options.backlog) < 0) {
+        perror("Error listening on Unix socket");
+        close(unixSocket);
+        throw std::runtime_error("Unix listen failed");
+    }
+
+    fcntl(unixSocket, F_SETFL, fcntl(unixSocket, F_GETFL) | O_NONBLOCK);
+    return unixSocket;
+}
+
+void Server::inheritListeners(const std::vector<int>& listeners) {
+    inherited = listeners;
+}
+
+// Sets up every configured listening socket
+void Server::setupSocket() {
+    // Inherited listeners keep the previous server's configuration
+    if (!inherited.empty()) {
+        for (int fd : inherited) {
+            int domain = AF_INET;
+            socklen_t len = sizeof(domain);
+            getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &domain, &len);
+            (domain == AF_UNIX ? unixSockets : tcpSockets).push_back(fd);
+        }
+        std::cout << "Took over " << inherited.size() << " listening sockets" << std::endl;
+        return;
+    }
+
+    // One TCP socket normally; with several acceptors each gets its own SO_REUSEPORT socket
+    bool reusePort = options.acceptors > 1;
+    for (int i = 0; i < options.acceptors; ++i) {
+        tcpSockets.push_back(createTcpListener(reusePort));
+    }
     std::cout << "Server is listening on port " << port << std::endl;  // Inform that the server is ready to accept connections
+
+    if (!options.unixPath.empty()) {
+        unixSockets.push_back(createUnixListener(options.unixPath, SOCK_STREAM));
+        std::cout << "Server is listening on " << options.unixPath << std::endl;
+    }
+    if (!options.seqpacketPath.empty()) {
+        unixSockets.push_back(createUnixListener(options.seqpacketPath, SOCK_SEQPACKET));
+        std::cout << "Server is listening on " << options.seqpacketPath << " (seqpacket)" << std::endl;
+    }
 }
 
 // Handles an individual client socket connection
-void Server::handleClient(int clientSocket) {
+void Server::handleClient(int clientSocket, const std::string& peer) {
     // Create a ConnectionHandler object to manage this client's connection
-    ConnectionHandler handler(clientSocket, bloom, &bloom_mutex);
+    ConnectionHandler handler(clientSocket, namespaces, &bloom_mutex, options);
     handler.handle();  // Handle the communication with the client
+    limiter.release(peer);
 }
 
-// Starts the server and waits for connections
-void Server::run() {
-    setupSocket();  // Set up the server socket, bind it, and start listening
-
-    sockaddr_in clientAddr{};  // Client's address information
-    socklen_t clientLen = sizeof(clientAddr);  // Length of client address structure
-
+// Accepts connections on one listening socket, one thread per client
+void Server::acceptLoop(int listenSocket) {
     while (true) {
-        // Accept incoming client connections
-        int clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &clientLen);
+        // Wait for a connection or for draining to start
+        pollfd ready[2] = {{listenSocket, POLLIN, 0}, {Lifecycle::drainFd(), POLLIN, 0}};
+        if (poll(ready, 2, -1) < 0) continue;
+        if (ready[1].revents) return;
+
+        // Accept incoming client connections (the peer address isn't needed)
+        int clientSocket = accept(listenSocket, nullptr, nullptr);
         if (clientSocket < 0) {  // Check if accepting a connection failed
-            perror("Error accepting connection");
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("Error accepting connection");
             continue;  // If accepting failed, continue to accept next connections
         }
-        threadManager->run([this, clientSocket]() {
-            this->handleClient(clientSocket);
-            close(clientSocket);
+
+        // Shed connections over the limits before they cost a thread
+        std::string peer = ConnectionLimiter::peerAddress(clientSocket);
+        if (limiter.admit(peer) != ConnectionLimiter::Verdict::ADMIT) {
+            ConnectionLimiter::reject(clientSocket);
+            continue;
+        }
+
+        threadManager->run([this, clientSocket, peer]() {
+            this->handleClient(clientSocket, peer);
         });
+    }
+}
+
+// Runs an io_uring loop per TCP listener, each on its own thread.
+// Unix listeners are served by the first loop.
+bool Server::runUring() {
+    std::vector<std::unique_ptr<UringServer>> loops;
+    for (size_t i = 0; i < tcpSockets.size(); ++i) {
+        std::vector<int> listeners{tcpSockets[i]};
+        if (i == 0) listeners.insert(listeners.end(), unixSockets.begin(), unixSockets.end());
+
+        loops.push_back(std::make_unique<UringServer>(listeners, namespaces, &bloom_mutex, options, &limiter));
+        if (!loops.back()->init()) return false;
+    }
+
+    std::cout << "Using io_uring backend" << std::endl;
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < loops.size(); ++i) {
+        workers.emplace_back([&loops, i]() { loops[i]->run(); });
+    }
+    loops[0]->run();
+
+    // Each loop returns once it is draining and its connections are closed
+    for (auto& worker : workers) worker.join();
+    return true;
+}
+
+// Waits for SIGTERM (blocked in every thread by main) or a successor, then starts draining
+void Server::watchForShutdown() {
+    sigset_t terminate;
+    sigemptyset(&terminate);
+    sigaddset(&terminate, SIGTERM);
+    int signals = signalfd(-1, &terminate, SFD_CLOEXEC);
+
+    int handoff = -1;
+    if (!options.handoffPath.empty()) {
+        handoff = Handoff::listen(options.handoffPath);
+        if (handoff < 0) perror("Error listening on handoff socket");
+    }
+
+    std::vector<int> listeners = tcpSockets;
+    listeners.insert(listeners.end(), unixSockets.begin(), unixSockets.end());
+
+    while (true) {
+        pollfd ready[2] = {{signals, POLLIN, 0}, {handoff, POLLIN, 0}};
+        if (poll(ready, handoff >= 0 ? 2 : 1, -1) < 0) continue;
+
+        if (ready[0].revents) {
+            std::cout << "SIGTERM received, draining" << std::endl;
+            break;
+        }
+
+        int next = accept(handoff, nullptr, nullptr);
+        if (next < 0) continue;
+        if (!Handoff::sendListeners(next, listeners)) {
+            close(next);  // The new server went away; keep serving
+            continue;
+        }
+        std::cout << "Listeners handed off, draining" << std::endl;
+        successor.store(next);
+        break;
+    }
+
+    Lifecycle::beginDrain();
+}
+
+// Completes the drain started by watchForShutdown once the acceptors have stopped
+void Server::finishShutdown() {
+    if (!Lifecycle::waitForConnections(options.drainTimeoutMs)) {
+        std::cerr << "Drain timed out with " << ServerStats::instance().active.load()
+                  << " connections open" << std::endl;
+    }
+
+    // A successor holds its own copies, so closing ours never refuses a connection it could take
+    for (int fd : tcpSockets) close(fd);
+    for (int fd : unixSockets) close(fd);
+
+    // Held until the process exits: nothing may change after the final snapshot
+    bloom_mutex.lock();
+    namespaces->saveSnapshots();
+
+    int next = successor.load();
+    if (next >= 0) {
+        Handoff::signalReady(next);
+        close(next);
+    }
+    Capture::flush();
+    std::cout << "Shutdown complete" << std::endl;
+}
+
+// Starts the server and waits for connections until a graceful shutdown
+void Server::run() {
+    setupSocket();  // Set up the listening sockets, bind them, and start listening
+    std::thread(&Server::watchForShutdown, this).detach();
+
+    // Use the io_uring event loops if requested and the kernel supports them
+    if (options.ioBackend == IoBackend::URING) {
+        if (runUring()) {
+            finishShutdown();
+            return;
+        }
+        std::cerr << "io_uring unavailable, falling back to threads" << std::endl;
+    }
 
+    // One accept worker per listening socket; the last runs on this thread
+    std::vector<int> listeners = tcpSockets;
+    listeners.insert(listeners.end(), unixSockets.begin(), unixSockets.end());
+    std::vector<std::thread> acceptors;
+    for (size_t i = 0; i + 1 < listeners.size(); ++i) {
+        acceptors.emplace_back(&Server::acceptLoop, this, listeners[i]);
     }
+    acceptLoop(listeners.back());
 
-    close(serverSocket);  // Unreachable unless the loop is broken (graceful shutdown)
+    for (auto& acceptor : acceptors) acceptor.join();
+    finishShutdown();
 }
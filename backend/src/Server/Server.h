@@ -1,14 +1,26 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <atomic>
 #include <string>
-#include "Bloom/BloomFilter.h"
+#include <vector>
+#include "Bloom/Namespaces.h"
 #include "ThreadManager.h"
+#include "ServerOptions.h"
+#include "ConnectionLimiter.h"
 
 /**
- * @brief The Server class handles setting up a TCP server socket,
+ * @brief The Server class handles setting up the listening sockets,
  * accepting incoming client connections, and delegating client
  * handling to ConnectionHandler instances.
+ *
+ * By default it listens on one IPv4 TCP socket. Options add N SO_REUSEPORT
+ * TCP listeners (the kernel spreads connections across them, each with its
+ * own accept worker) and Unix domain listeners for clients on the same host.
+ *
+ * SIGTERM, or a successor connecting to the --handoff socket, drains the
+ * server: acceptors stop, open connections finish their current request, the
+ * filters are written as snapshots, and run() returns.
  */
 class Server {
 public:
@@ -16,32 +28,88 @@ public:
      * @brief Constructor for the Server class.
      * @param port Port number the server will listen on.
      * @param configLine Configuration string passed to clients (e.g., Bloom filter settings).
+     * @param namespaces The filters to serve, shared by every connection.
+     * @param options Optional settings such as the I/O backend and extra listeners.
      */
-    Server(int port, const std::string& configLine, BloomFilter* bloom, ThreadManager* manager);
+    Server(int port, const std::string& configLine, Namespaces* namespaces, ThreadManager* manager,
+           const ServerOptions& options = ServerOptions());
+
+    /**
+     * @brief Uses listening sockets passed on by a previous server instead of creating them.
+     * @param listeners Inherited TCP and Unix domain listeners, in any order.
+     */
+    void inheritListeners(const std::vector<int>& listeners);
 
     /**
      * @brief Starts the server and enters the main accept loop to handle clients.
+     *        Returns once a graceful shutdown has completed.
      */
     void run();
 
 private:
     int port;                  // Port number to listen on
-    int serverSocket;          // Server socket file descriptor
+    std::vector<int> tcpSockets;   // TCP listening sockets (one per acceptor)
+    std::vector<int> unixSockets;  // Unix domain listening sockets
     std::string configLine;    // Configuration line to pass to each ConnectionHandler
-    BloomFilter* bloom;
+    Namespaces* namespaces;
     ThreadManager* threadManager;
+    ServerOptions options;     // Optional settings given on the command line
+    ConnectionLimiter limiter; // Connection caps and per-IP rate limits, shared by every acceptor
+    std::vector<int> inherited;    // Listeners received from the previous server, if any
+    std::atomic<int> successor{-1};  // Handoff connection of the server taking over, if any
 
 
     /**
-     * @brief Initializes and configures the server socket.
+     * @brief Creates every configured listening socket.
      */
     void setupSocket();
 
+    /**
+     * @brief Creates a TCP socket bound to all interfaces on the server port.
+     * @param reusePort Set SO_REUSEPORT so several sockets can share the port.
+     * @return The listening socket.
+     */
+    int createTcpListener(bool reusePort);
+
+    /**
+     * @brief Creates a Unix domain socket listening on the given path.
+     * @param path Filesystem path of the socket (replaced if it exists).
+     * @param type SOCK_STREAM or SOCK_SEQPACKET.
+     * @return The listening socket.
+     */
+    int createUnixListener(const std::string& path, int type);
+
+    /**
+     * @brief Accepts connections on one listening socket until draining starts,
+     *        handing each admitted one to its own thread and resetting the rest.
+     * @param listenSocket The listening socket to accept on.
+     */
+    void acceptLoop(int listenSocket);
+
+    /**
+     * @brief Runs one io_uring loop per TCP listener (Unix listeners join the first).
+     * @return false if io_uring is unavailable and the threaded backend should be used.
+     */
+    bool runUring();
+
+    /**
+     * @brief Waits for SIGTERM or a successor on the handoff socket, then starts draining.
+     *        A successor is sent the listening sockets first.
+     */
+    void watchForShutdown();
+
+    /**
+     * @brief Finishes a drain: waits for open connections, closes the
+     *        listeners, writes the final snapshot and releases the successor.
+     */
+    void finishShutdown();
+
     /**
      * @brief Handles an individual client connection.
      * @param clientSocket The socket file descriptor for the connected client.
+     * @param peer The client's IP address, released from the limiter when done.
      */
-    void handleClient(int clientSocket);
+    void handleClient(int clientSocket, const std::string& peer);
 };
 
 #endif // SERVER_H
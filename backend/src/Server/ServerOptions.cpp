@@ -0,0 +1,97 @@
+#include "ServerOptions.h"
+#include <algorithm>   // For std::all_of
+#include <cctype>      // For ::isdigit
+#include <cstdint>     // For INT32_MAX
+
+// Parses a strictly positive integer no larger than max
+static bool parsePositive(const std::string& value, int max, int& out) {
+    if (value.empty() || value.size() > 9 || !std::all_of(value.begin(), value.end(), ::isdigit)) return false;
+    int parsed = std::stoi(value);
+    if (parsed <= 0 || parsed > max) return false;
+    out = parsed;
+    return true;
+}
+
+// Parses a "--name=value" argument and stores its value in the options struct.
+// Unknown names and malformed values are rejected so typos don't go unnoticed.
+bool parseServerOption(const std::string& arg, ServerOptions& options) {
+    if (arg.compare(0, 2, "--") != 0) return false;
+
+    size_t eq = arg.find('=');
+    if (eq == std::string::npos) return false;
+    std::string name = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+
+    if (name == "io") {
+        if (value == "threads") options.ioBackend = IoBackend::THREADS;
+        else if (value == "uring") options.ioBackend = IoBackend::URING;
+        else return false;
+        return true;
+    }
+
+    if (name == "backlog") return parsePositive(value, 1 << 20, options.backlog);
+    if (name == "acceptors") return parsePositive(value, 256, options.acceptors);
+    if (name == "default-ttl") return parsePositive(value, INT32_MAX, options.defaultTtl);
+    if (name == "generation-seconds") return parsePositive(value, INT32_MAX, options.generationSeconds);
+    if (name == "max-connections") return parsePositive(value, 1 << 24, options.maxConnections);
+    if (name == "max-per-ip") return parsePositive(value, 1 << 24, options.maxPerIp);
+    if (name == "rate-per-ip") return parsePositive(value, 1 << 24, options.ratePerIp);
+    if (name == "burst-per-ip") return parsePositive(value, 1 << 24, options.burstPerIp);
+    if (name == "idle-timeout-ms") return parsePositive(value, INT32_MAX, options.idleTimeoutMs);
+    if (name == "read-timeout-ms") return parsePositive(value, INT32_MAX, options.readTimeoutMs);
+    if (name == "max-line") return parsePositive(value, 1 << 20, options.maxLine);
+    if (name == "drain-timeout-ms") return parsePositive(value, INT32_MAX, options.drainTimeoutMs);
+    if (name == "ttl-generations") return parsePositive(value, 1024, options.ttlGenerations);
+    if (name == "max-namespace-bits") return parsePositive(value, INT32_MAX, options.maxNamespaceBits);
+    if (name == "max-hash-depth") return parsePositive(value, INT32_MAX, options.maxHashDepth);
+
+    if (name == "huge-pages") {
+        if (value == "off") options.hugePages = HugePages::OFF;
+        else if (value == "thp") options.hugePages = HugePages::THP;
+        else if (value == "hugetlb") options.hugePages = HugePages::HUGETLB;
+        else return false;
+        return true;
+    }
+
+    if (name == "trace") {
+        if (value == "on") options.trace = true;
+        else if (value == "off") options.trace = false;
+        else return false;
+        return true;
+    }
+
+    if (name == "hot-keys") {
+        if (value == "on") options.hotKeys = true;
+        else if (value == "off") options.hotKeys = false;
+        else return false;
+        return true;
+    }
+
+    if (name == "numa-replicate") {
+        if (value == "on") options.numaReplicate = true;
+        else if (value == "off") options.numaReplicate = false;
+        else return false;
+        return true;
+    }
+
+    if (name == "verdict-cache" || name == "fp-memo") {
+        int& entries = name == "verdict-cache" ? options.verdictCache : options.fpMemo;
+        if (value == "off") {
+            entries = 0;
+            return true;
+        }
+        return parsePositive(value, 1 << 26, entries);
+    }
+
+    if (name == "unix" || name == "unix-seqpacket" || name == "handoff" || name == "capture") {
+        if (value.empty()) return false;
+        std::string& path = name == "unix" ? options.unixPath
+                          : name == "unix-seqpacket" ? options.seqpacketPath
+                          : name == "handoff" ? options.handoffPath
+                          : options.capturePath;
+        path = value;
+        return true;
+    }
+
+    return false;  // Unknown option
+}
@@ -0,0 +1,53 @@
+#ifndef SERVER_OPTIONS_H
+#define SERVER_OPTIONS_H
+
+#include <string>
+#include "Bloom/PageArena.h"   // For HugePages
+
+// I/O backend used to accept connections and move bytes.
+enum class IoBackend {
+    THREADS,  // Blocking sockets, one thread per connection (default)
+    URING     // Single event loop on io_uring; falls back to THREADS if unsupported
+};
+
+// Optional server settings, given on the command line as "--name=value"
+// before or after the positional arguments.
+struct ServerOptions {
+    IoBackend ioBackend = IoBackend::THREADS;  // --io=threads|uring
+    int backlog = 100;                         // --backlog=N, listen() queue length per listener
+    int acceptors = 1;                         // --acceptors=N, SO_REUSEPORT TCP listeners, one worker each
+    std::string unixPath;                      // --unix=PATH, extra SOCK_STREAM Unix domain listener
+    std::string seqpacketPath;                 // --unix-seqpacket=PATH, extra SOCK_SEQPACKET Unix listener
+    int defaultTtl = 0;                        // --default-ttl=SECONDS, TTL for POSTs without one (0: never expire)
+    int generationSeconds = 3600;              // --generation-seconds=N, time span of each aging generation
+    int ttlGenerations = 4;                    // --ttl-generations=N, number of aging generations
+    HugePages hugePages = HugePages::OFF;      // --huge-pages=off|thp|hugetlb, for the bit arrays and blacklist
+    bool numaReplicate = false;                // --numa-replicate=on|off, a bit array copy per NUMA node
+    int maxConnections = 0;                    // --max-connections=N, concurrent connections (0: unlimited)
+    int maxPerIp = 0;                          // --max-per-ip=N, concurrent connections per client IP (0: unlimited)
+    int ratePerIp = 0;                         // --rate-per-ip=N, new connections per second per client IP (0: unlimited)
+    int burstPerIp = 0;                        // --burst-per-ip=N, token bucket size for --rate-per-ip (default: the rate)
+    int idleTimeoutMs = 30000;                 // --idle-timeout-ms=N, close after N ms without a request
+    int readTimeoutMs = 10000;                 // --read-timeout-ms=N, close if one request takes longer to arrive
+    int maxLine = 8192;                        // --max-line=BYTES, longest accepted text command
+    bool trace = true;                         // --trace=on|off, record request spans for TRACE DUMP / SIGUSR1
+    bool hotKeys = true;                       // --hot-keys=on|off, count heavy hitters for TOPK
+    std::string handoffPath;                   // --handoff=PATH, Unix socket for passing the listeners to a new process
+    int drainTimeoutMs = 10000;                // --drain-timeout-ms=N, longest wait for connections on shutdown
+    std::string capturePath;                   // --capture=PATH, record requests and responses for the replay tool
+    int verdictCache = 65536;                  // --verdict-cache=ENTRIES|off, cached GET verdicts per namespace (off: 0)
+    int fpMemo = 65536;                        // --fp-memo=ENTRIES|off, remembered false positives per namespace (off: 0)
+    int maxNamespaceBits = 1 << 28;            // --max-namespace-bits=N, largest filter a CREATE may ask for
+    int maxHashDepth = 64;                     // --max-hash-depth=N, deepest hash function a CREATE may ask for
+};
+
+/**
+ * Parses a single "--name=value" argument into the options struct.
+ *
+ * @param arg      The raw command-line argument (must start with "--")
+ * @param options  Output: the options struct to update
+ * @return true if the option is known and its value is valid
+ */
+bool parseServerOption(const std::string& arg, ServerOptions& options);
+
+#endif // SERVER_OPTIONS_H
@@ -0,0 +1,28 @@
+#include "ServerStats.h"
+#include "Lifecycle.h"   // Drain state
+
+ServerStats& ServerStats::instance() {
+    static ServerStats stats;
+    return stats;
+}
+
+std::string ServerStats::format() const {
+    std::string out;
+    auto line = [&out](const char* name, long long value) {
+        if (!out.empty()) out += "\n";
+        out += name;
+        out += " ";
+        out += std::to_string(value);
+    };
+
+    line("connections_accepted", accepted.load(std::memory_order_relaxed));
+    line("connections_active", active.load(std::memory_order_relaxed));
+    line("shed_capacity", shedCapacity.load(std::memory_order_relaxed));
+    line("shed_per_ip", shedPerIp.load(std::memory_order_relaxed));
+    line("shed_rate", shedRate.load(std::memory_order_relaxed));
+    line("idle_timeouts", idleTimeouts.load(std::memory_order_relaxed));
+    line("read_timeouts", readTimeouts.load(std::memory_order_relaxed));
+    line("oversized_requests", oversizedRequests.load(std::memory_order_relaxed));
+    line("draining", Lifecycle::draining() ? 1 : 0);
+    return out;
+}
@@ -0,0 +1,37 @@
+#ifndef SERVER_STATS_H
+#define SERVER_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Process-wide server counters, reported by the STATS command.
+ *
+ * Every backend updates the same instance; counters are relaxed atomics
+ * since they are only read for reporting. The report also says whether the
+ * server is draining, so load balancer health checks can stop routing to it.
+ */
+class ServerStats {
+public:
+    static ServerStats& instance();
+
+    std::atomic<uint64_t> accepted{0};           // Connections accepted, including shed ones
+    std::atomic<int64_t> active{0};              // Connections currently being served
+    std::atomic<uint64_t> shedCapacity{0};       // Rejected: --max-connections reached
+    std::atomic<uint64_t> shedPerIp{0};          // Rejected: --max-per-ip reached for the client's address
+    std::atomic<uint64_t> shedRate{0};           // Rejected: the address's token bucket was empty
+    std::atomic<uint64_t> idleTimeouts{0};       // Closed after --idle-timeout-ms without a request
+    std::atomic<uint64_t> readTimeouts{0};       // Closed after --read-timeout-ms inside one request
+    std::atomic<uint64_t> oversizedRequests{0};  // Closed for a line longer than --max-line
+
+    /**
+     * @brief Formats every counter as "name value" lines, joined by '\n'.
+     */
+    std::string format() const;
+
+private:
+    ServerStats() = default;
+};
+
+#endif // SERVER_STATS_H
@@ -0,0 +1,484 @@
+#include "UringServer.h"
+#include "ConnectionHandler.h"         // Shared command line processing
+#include "BinaryProtocol.h"            // Magic byte for protocol detection
+#include "ServerStats.h"               // Timeout and oversized request counters
+#include "Lifecycle.h"                 // Drain notification
+
+#include <iostream>                    // For std::cout and std::cerr
+#include <cstring>                     // For std::memset
+#include <cerrno>
+#include <chrono>
+#include <poll.h>                      // For POLLIN
+#include <sys/mman.h>                  // For mmap(), munmap()
+#include <sys/socket.h>                // For SHUT_WR, MSG_NOSIGNAL
+#include <sys/syscall.h>               // For the io_uring syscall numbers
+#include <unistd.h>                    // For close(), syscall()
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HAVE_IO_URING 1
+#endif
+
+#ifdef HAVE_IO_URING
+
+namespace {
+
+// Operation tags stored in the low bits of each SQE's user_data
+enum Op : uint64_t { OP_ACCEPT = 1, OP_RECV = 2, OP_SEND = 3, OP_SHUTDOWN = 4, OP_CLOSE = 5, OP_SWEEP = 6, OP_DRAIN = 7 };
+const unsigned OP_BITS = 3;
+
+uint64_t tag(uint64_t id, Op op) { return (id << OP_BITS) | op; }
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+UringServer::UringServer(const std::vector<int>& listenSockets, Namespaces* namespaces, std::mutex* bloom_mutex,
+                         const ServerOptions& options, ConnectionLimiter* limiter)
+    : listenSockets(listenSockets), namespaces(namespaces), bloom_mutex(bloom_mutex), options(options), limiter(limiter) {}
+
+UringServer::~UringServer() {
+    for (auto& entry : connections) {
+        close(entry.second.fd);
+        limiter->release(entry.second.peer);
+    }
+    if (bufPool) munmap(bufPool, BUF_COUNT * BUF_SIZE);
+    if (bufRing) munmap(bufRing, bufRingSize);
+    if (sqes) munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing) munmap(sqRing, sqRingSize);
+    if (ringFd >= 0) close(ringFd);
+}
+
+// Creates the ring, maps its queues, and registers the provided buffer ring.
+// Any failure means the kernel can't run this backend.
+bool UringServer::init() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = RING_ENTRIES * 8;  // Multishot accept and bursts can outrun the SQ size
+
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (ringFd < 0) return false;
+
+    // Map the submission and completion rings (a single mapping on newer kernels)
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap && cqRingSize > sqRingSize) sqRingSize = cqRingSize;
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) { sqRing = nullptr; return false; }
+    if (singleMmap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) { cqRing = nullptr; return false; }
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqeMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqeMap == MAP_FAILED) return false;
+    sqes = static_cast<io_uring_sqe*>(sqeMap);
+
+    char* sq = static_cast<char*>(sqRing);
+    sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+    sqLocalTail = *sqTail;
+
+    char* cq = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // Provided buffer ring: the kernel picks a free buffer for each receive.
+    // Registering it requires 5.19, the same release that added multishot accept.
+    bufRingSize = BUF_COUNT * sizeof(io_uring_buf);
+    void* ringMap = mmap(nullptr, bufRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ringMap == MAP_FAILED) return false;
+    bufRing = static_cast<io_uring_buf_ring*>(ringMap);
+
+    void* poolMap = mmap(nullptr, BUF_COUNT * BUF_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (poolMap == MAP_FAILED) return false;
+    bufPool = static_cast<char*>(poolMap);
+    receivePool.update(bufRingSize + BUF_COUNT * BUF_SIZE);
+
+    io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing);
+    reg.ring_entries = BUF_COUNT;
+    reg.bgid = BUF_GROUP;
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) return false;
+
+    for (unsigned bid = 0; bid < BUF_COUNT; ++bid) {
+        recycleBuffer(static_cast<uint16_t>(bid));
+    }
+    return true;
+}
+
+// Returns a zeroed SQE, flushing the queue to the kernel first if it is full
+io_uring_sqe* UringServer::getSqe() {
+    if (sqLocalTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+        submit(0);
+    }
+    unsigned index = sqLocalTail & *sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    ++sqLocalTail;
+    return sqe;
+}
+
+// Publishes all queued SQEs and, if asked, waits for completions — one syscall for the whole batch
+int UringServer::submit(unsigned waitFor) {
+    unsigned toSubmit = sqLocalTail - *sqTail;
+    __atomic_store_n(sqTail, sqLocalTail, __ATOMIC_RELEASE);
+
+    unsigned flags = waitFor ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    do {
+        ret = static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, waitFor, flags, nullptr, 0));
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+// Hands a receive buffer back to the kernel
+void UringServer::recycleBuffer(uint16_t bid) {
+    // Index the ring by hand: in C++ the header's flexible "bufs" member sits after
+    // a one-byte empty struct, 8 bytes later than where the kernel reads entries
+    io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(bufRing) + (bufTail & (BUF_COUNT - 1));
+    buf->addr = reinterpret_cast<uint64_t>(bufPool + static_cast<size_t>(bid) * BUF_SIZE);
+    buf->len = BUF_SIZE;
+    buf->bid = bid;
+    ++bufTail;
+    __atomic_store_n(&bufRing->tail, bufTail, __ATOMIC_RELEASE);
+}
+
+// One SQE keeps producing a completion per accepted connection.
+// The listener's index travels in the ID bits so it can be re-armed.
+void UringServer::armAccept(size_t listener) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenSockets[listener];
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = tag(listener, OP_ACCEPT);
+}
+
+// Receives into whichever provided buffer the kernel picks
+void UringServer::armRecv(uint64_t id, Connection& conn) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn.fd;
+    sqe->len = BUF_SIZE;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUF_GROUP;
+    sqe->user_data = tag(id, OP_RECV);
+    ++conn.inflight;
+}
+
+// Sends the unsent part of the oldest queued response
+void UringServer::armSend(uint64_t id, Connection& conn) {
+    const std::string& out = conn.outbox.front();
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(out.data() + conn.sentBytes);
+    sqe->len = static_cast<uint32_t>(out.size() - conn.sentBytes);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = tag(id, OP_SEND);
+    conn.sending = true;
+    ++conn.inflight;
+}
+
+// Half-closes the connection after a response, as the blocking backend does
+void UringServer::armShutdown(uint64_t id, Connection& conn) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_SHUTDOWN;
+    sqe->fd = conn.fd;
+    sqe->len = SHUT_WR;
+    sqe->user_data = tag(id, OP_SHUTDOWN);
+    ++conn.inflight;
+}
+
+// Wakes the loop once per interval to enforce timeouts
+void UringServer::armSweep() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = reinterpret_cast<uint64_t>(sweepInterval);
+    sqe->len = 1;
+    sqe->user_data = tag(0, OP_SWEEP);
+}
+
+// Completes once the server starts draining
+void UringServer::armDrain() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = Lifecycle::drainFd();
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = tag(0, OP_DRAIN);
+}
+
+// Stops accepting and starts closing idle connections; the sweep then runs
+// more often so connections that finish a request are closed promptly
+void UringServer::startDrain() {
+    draining = true;
+    for (size_t i = 0; i < listenSockets.size(); ++i) {
+        io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = tag(i, OP_ACCEPT);
+        sqe->user_data = tag(0, OP_CLOSE);  // Nothing to do on completion
+    }
+    sweepInterval[0] = 0;
+    sweepInterval[1] = 100 * 1000 * 1000;
+    sweepTimeouts();
+}
+
+// Shuts down connections that were idle or mid-request for too long, and
+// when draining, every connection between requests.
+// Their pending receive then completes with 0 and the normal close path runs.
+void UringServer::sweepTimeouts() {
+    ServerStats& stats = ServerStats::instance();
+    int64_t now = nowMs();
+    for (auto& entry : connections) {
+        Connection& conn = entry.second;
+        if (conn.closing || conn.timedOut) continue;
+
+        if (draining && conn.detected && !conn.midRequest() && conn.outbox.empty()) {
+            // Idle after a request: close it as part of the drain. A new connection
+            // is left to send its first request, which is surely on its way.
+        } else if (conn.midRequest() && now - conn.requestStart > options.readTimeoutMs) {
+            stats.readTimeouts.fetch_add(1, std::memory_order_relaxed);
+        } else if (!conn.midRequest() && now - conn.lastActivity > options.idleTimeoutMs) {
+            stats.idleTimeouts.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            continue;
+        }
+        conn.timedOut = true;
+        shutdown(conn.fd, SHUT_RDWR);
+    }
+}
+
+void UringServer::onAccept(size_t listener, int res, uint32_t flags) {
+    // The multishot accept stops on some errors; re-arm it when that happens, unless draining cancelled it
+    if (!(flags & IORING_CQE_F_MORE) && !draining) armAccept(listener);
+    if (res < 0) return;
+
+    // Shed connections over the limits before they take any buffers
+    std::string peer = ConnectionLimiter::peerAddress(res);
+    if (limiter->admit(peer) != ConnectionLimiter::Verdict::ADMIT) {
+        ConnectionLimiter::reject(res);
+        return;
+    }
+
+    uint64_t id = nextConnectionId++;
+    Connection& conn = connections[id];
+    conn.fd = res;
+    conn.peer = std::move(peer);
+    conn.lastActivity = nowMs();
+    armRecv(id, conn);
+}
+
+void UringServer::onRecv(uint64_t id, int res, uint32_t flags) {
+    Connection& conn = connections.at(id);
+
+    if (flags & IORING_CQE_F_BUFFER) {
+        uint16_t bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (res > 0) {
+            conn.lastActivity = nowMs();
+            if (!conn.midRequest()) conn.requestStart = conn.lastActivity;
+            conn.leftover.append(bufPool + static_cast<size_t>(bid) * BUF_SIZE, res);
+        }
+        recycleBuffer(bid);
+    }
+
+    if (res == -ENOBUFS) {  // Every buffer was busy; try again on the next batch
+        armRecv(id, conn);
+        return;
+    }
+    if (res <= 0) {         // Peer closed the connection or an error occurred
+        conn.closing = true;
+        return;
+    }
+
+    // A binary client announces itself with the magic byte as its very first byte
+    if (!conn.detected) {
+        conn.binary = static_cast<uint8_t>(conn.leftover[0]) == BinaryProtocol::MAGIC;
+        conn.detected = true;
+    }
+
+    if (conn.binary) {
+        std::string out;
+        bool ok = ConnectionHandler::processFrames(conn.leftover, out, namespaces, bloom_mutex);
+        if (!out.empty()) {
+            conn.outbox.push_back(std::move(out));
+            if (!conn.sending) armSend(id, conn);
+        }
+        if (!ok) {
+            conn.closing = true;  // Malformed stream: flush the error reply, then close
+            return;
+        }
+        armRecv(id, conn);
+        return;
+    }
+
+    // Process full lines (commands are separated by '\n'); a SCAN line is followed by its body
+    bool queued = false;
+    while (true) {
+        if (conn.scan) {
+            std::string response;
+            if (!ConnectionHandler::feedScan(*conn.scan, conn.leftover, response, namespaces, bloom_mutex)) break;
+            conn.scan.reset();
+            conn.outbox.push_back(std::move(response));
+            queued = true;
+            continue;
+        }
+
+        size_t pos = conn.leftover.find('\n');
+        if (pos == std::string::npos) break;
+        std::string line = conn.leftover.substr(0, pos);
+        conn.leftover.erase(0, pos + 1);
+        if ((conn.scan = ConnectionHandler::startScan(line))) continue;
+        conn.outbox.push_back(ConnectionHandler::processLine(line, namespaces, bloom_mutex));
+        queued = true;
+
+        // An invalid SCAN line is still followed by a body, which must not run as commands: close once answered
+        if (ConnectionHandler::isScanLine(line)) {
+            conn.leftover.clear();
+            conn.closing = true;
+            if (!conn.sending) armSend(id, conn);
+            return;
+        }
+    }
+
+    // A partial line can't grow without bound: answer 400 and close once it's sent
+    if (conn.leftover.size() > static_cast<size_t>(options.maxLine)) {
+        ServerStats::instance().oversizedRequests.fetch_add(1, std::memory_order_relaxed);
+        conn.leftover.clear();
+        conn.outbox.push_back("400 Bad Request\n");
+        conn.closing = true;
+        if (!conn.sending) armSend(id, conn);
+        return;
+    }
+
+    if (queued && !conn.sending) armSend(id, conn);
+
+    armRecv(id, conn);
+}
+
+void UringServer::onSend(uint64_t id, int res) {
+    Connection& conn = connections.at(id);
+    conn.sending = false;
+
+    if (res < 0) {
+        // The peer is gone or the write side is shut; nothing more can be delivered
+        conn.outbox.clear();
+        conn.sentBytes = 0;
+        return;
+    }
+
+    conn.sentBytes += static_cast<size_t>(res);
+    if (conn.sentBytes < conn.outbox.front().size()) {
+        armSend(id, conn);  // Short send: continue where it stopped
+        return;
+    }
+
+    conn.outbox.pop_front();
+    conn.sentBytes = 0;
+    if (!conn.binary) armShutdown(id, conn);
+    if (!conn.outbox.empty()) armSend(id, conn);
+}
+
+void UringServer::countBuffers(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& conn = it->second;
+    size_t bytes = MemoryStats::heapBytes(conn.leftover);
+    for (const std::string& response : conn.outbox) bytes += MemoryStats::heapBytes(response);
+    conn.buffers.update(bytes);
+}
+
+// Drops one in-flight operation and closes the connection once nothing references it
+void UringServer::finishOp(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& conn = it->second;
+    if (--conn.inflight > 0 || !conn.closing) return;
+
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = conn.fd;
+    sqe->user_data = tag(0, OP_CLOSE);
+    limiter->release(conn.peer);
+    connections.erase(it);
+}
+
+void UringServer::run() {
+    for (size_t i = 0; i < listenSockets.size(); ++i) {
+        armAccept(i);
+    }
+    armSweep();
+    armDrain();
+
+    while (!draining || !connections.empty()) {
+        // Submit everything queued since the last pass and wait for at least one completion
+        if (submit(1) < 0) {
+            perror("io_uring_enter failed");
+            continue;
+        }
+
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & *cqMask];
+            uint64_t id = cqe.user_data >> OP_BITS;
+
+            switch (cqe.user_data & ((1u << OP_BITS) - 1)) {
+                case OP_ACCEPT:
+                    onAccept(id, cqe.res, cqe.flags);
+                    break;
+                case OP_RECV:
+                    onRecv(id, cqe.res, cqe.flags);
+                    countBuffers(id);
+                    finishOp(id);
+                    break;
+                case OP_SEND:
+                    onSend(id, cqe.res);
+                    countBuffers(id);
+                    finishOp(id);
+                    break;
+                case OP_SHUTDOWN:
+                    finishOp(id);
+                    break;
+                case OP_SWEEP:
+                    sweepTimeouts();
+                    armSweep();
+                    break;
+                case OP_DRAIN:
+                    startDrain();
+                    break;
+                default:  // OP_CLOSE: nothing left to track
+                    break;
+            }
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+#else  // !HAVE_IO_URING
+
+// Built without io_uring headers: always report the backend as unavailable
+UringServer::UringServer(const std::vector<int>& listenSockets, Namespaces* namespaces, std::mutex* bloom_mutex,
+                         const ServerOptions& options, ConnectionLimiter* limiter)
+    : listenSockets(listenSockets), namespaces(namespaces), bloom_mutex(bloom_mutex), options(options), limiter(limiter) {}
+UringServer::~UringServer() {}
+bool UringServer::init() { return false; }
+void UringServer::run() {}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef URING_SERVER_H
+#define URING_SERVER_H
+
+#include <mutex>
+#include <string>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include "Bloom/Namespaces.h"
+#include "ServerOptions.h"
+#include "ConnectionLimiter.h"
+#include "ConnectionHandler.h"
+#include "MemoryStats.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+/**
+ * @brief Single-threaded io_uring event loop, an alternative to the
+ * thread-per-connection model in Server. Server runs one per TCP acceptor.
+ *
+ * Connections are accepted with one multishot accept per listener, data is received into a
+ * ring of kernel-provided buffers (no per-recv buffer setup), and all sends,
+ * shutdowns and re-armed receives produced while draining completions are
+ * submitted together with a single io_uring_enter call.
+ *
+ * Talks to the kernel through raw syscalls, so it has no liburing dependency.
+ * init() returns false when the kernel (or build headers) lack the features
+ * needed (provided buffer rings and multishot accept, Linux 5.19+), and the
+ * caller falls back to the blocking backend.
+ *
+ * Connections go through the shared ConnectionLimiter on accept. A timeout
+ * re-armed every second sweeps for connections past their idle or read
+ * timeout and shuts them down, which completes their pending receive.
+ *
+ * When the server starts draining, the accepts are cancelled, idle
+ * connections are shut down, and run() returns once none are left.
+ */
+class UringServer {
+public:
+    /**
+     * @param listenSockets Bound, listening server sockets (TCP or Unix domain).
+     * @param namespaces The shared filters, by namespace.
+     * @param bloom_mutex Mutex guarding every namespace.
+     * @param options Timeouts and the maximum line length; must outlive the loop.
+     * @param limiter Admission control shared with the other acceptors.
+     */
+    UringServer(const std::vector<int>& listenSockets, Namespaces* namespaces, std::mutex* bloom_mutex,
+                const ServerOptions& options, ConnectionLimiter* limiter);
+    ~UringServer();
+
+    UringServer(const UringServer&) = delete;
+    UringServer& operator=(const UringServer&) = delete;
+
+    /**
+     * @brief Sets up the ring and the provided buffer ring.
+     * @return false if io_uring or a required feature is unavailable.
+     */
+    bool init();
+
+    /**
+     * @brief Runs the event loop until draining has closed every connection.
+     */
+    void run();
+
+private:
+    // Per-connection state kept between completions
+    struct Connection {
+        int fd;
+        std::string leftover;               // Partial line received so far
+        std::deque<std::string> outbox;     // Responses waiting to be sent, in order
+        size_t sentBytes = 0;               // Bytes of outbox.front() already sent
+        bool sending = false;               // A send is in flight
+        bool closing = false;               // Peer closed or errored; close once idle
+        int inflight = 0;                   // Operations still owned by the kernel
+        bool detected = false;              // Protocol decided from the first byte
+        bool binary = false;                // Speaks the binary protocol (stays open, no half-close)
+        std::string peer;                   // Client IP address, for the limiter
+        int64_t lastActivity = 0;           // Last receive, in steady-clock ms
+        int64_t requestStart = 0;           // When the buffered partial request began
+        bool timedOut = false;              // Already shut down by the timeout sweep or the drain
+        std::unique_ptr<ConnectionHandler::PendingScan> scan;  // SCAN whose body is still arriving
+        MemoryCounter::Holding buffers{MemoryStats::instance().connectionBuffers};  // leftover and outbox
+
+        // A request has started arriving but isn't complete
+        bool midRequest() const { return !leftover.empty() || scan; }
+    };
+
+    static const unsigned RING_ENTRIES = 256;   // Submission queue size
+    static const unsigned BUF_COUNT = 256;      // Provided receive buffers (power of two)
+    static const unsigned BUF_SIZE = 4096;      // Size of each receive buffer
+    static const uint16_t BUF_GROUP = 1;        // Buffer group ID used by receives
+
+    std::vector<int> listenSockets;
+    Namespaces* namespaces;
+    std::mutex* bloom_mutex;
+    const ServerOptions& options;
+    ConnectionLimiter* limiter;
+    int64_t sweepInterval[2] = {1, 0};      // __kernel_timespec for the sweep timeout: 1 s, 100 ms when draining
+    bool draining = false;                  // Accepts cancelled; closing connections as they go idle
+
+    // Submission/completion ring mappings
+    int ringFd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqEntries = 0;
+    unsigned sqLocalTail = 0;               // Tail including SQEs not yet published
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    // Provided buffer ring for receives
+    io_uring_buf_ring* bufRing = nullptr;
+    size_t bufRingSize = 0;
+    char* bufPool = nullptr;
+    uint16_t bufTail = 0;
+    MemoryCounter::Holding receivePool{MemoryStats::instance().connectionBuffers};  // bufRing and bufPool
+
+    std::unordered_map<uint64_t, Connection> connections;  // Keyed by connection ID
+    uint64_t nextConnectionId = 1;
+
+    io_uring_sqe* getSqe();
+    int submit(unsigned waitFor);
+    void recycleBuffer(uint16_t bid);
+
+    // Re-counts a connection's buffers after a completion may have changed them
+    void countBuffers(uint64_t id);
+
+    void armAccept(size_t listener);
+    void armRecv(uint64_t id, Connection& conn);
+    void armSend(uint64_t id, Connection& conn);
+    void armShutdown(uint64_t id, Connection& conn);
+    void armSweep();
+    void armDrain();
+
+    void onAccept(size_t listener, int res, uint32_t flags);
+    void onRecv(uint64_t id, int res, uint32_t flags);
+    void onSend(uint64_t id, int res);
+    void finishOp(uint64_t id);
+    void sweepTimeouts();
+    void startDrain();
+};
+
+#endif // URING_SERVER_H
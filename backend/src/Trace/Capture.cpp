@@ -0,0 +1,130 @@
+#include "Capture.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+
+namespace Capture {
+
+namespace {
+
+const char MAGIC[8] = {'B', 'L', 'M', 'C', 'A', 'P', '1', '\n'};
+const size_t FLUSH_BYTES = 64 * 1024;
+const uint64_t FLUSH_US = 1000000;
+
+std::atomic<bool> capturing{false};
+std::mutex writerMutex;
+FILE* file = nullptr;
+std::string buffer;                    // Records not yet written
+std::chrono::steady_clock::time_point start;
+uint64_t lastUs = 0;                   // Time of the previous record
+uint64_t flushedUs = 0;                // Time of the last write
+
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+bool readVarint(const std::string& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (unsigned shift = 0; pos < in.size() && shift < 64; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// The caller holds writerMutex
+void writeBuffer() {
+    if (!file || buffer.empty()) return;
+    std::fwrite(buffer.data(), 1, buffer.size(), file);
+    std::fflush(file);
+    buffer.clear();
+}
+
+} // namespace
+
+bool open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    uint64_t startUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    buffer.assign(MAGIC, sizeof(MAGIC));
+    for (int i = 0; i < 8; ++i) buffer += static_cast<char>(startUs >> (8 * i));
+    writeBuffer();
+
+    start = std::chrono::steady_clock::now();
+    capturing.store(true);
+    return true;
+}
+
+bool enabled() {
+    return capturing.load(std::memory_order_relaxed);
+}
+
+void record(Kind kind, const char* request, size_t requestLength, const char* response, size_t responseLength) {
+    if (!enabled()) return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    // Taken under the lock, so times never go backwards in the file
+    uint64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    buffer += static_cast<char>(kind);
+    appendVarint(buffer, now - lastUs);
+    appendVarint(buffer, requestLength);
+    buffer.append(request, requestLength);
+    appendVarint(buffer, responseLength);
+    buffer.append(response, responseLength);
+    lastUs = now;
+
+    if (buffer.size() >= FLUSH_BYTES || now - flushedUs >= FLUSH_US) {
+        writeBuffer();
+        flushedUs = now;
+    }
+}
+
+void flush() {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    writeBuffer();
+}
+
+bool load(const std::string& path, std::vector<Record>& records) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < 16 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    size_t pos = 16;
+    uint64_t time = 0;
+    while (pos < data.size()) {
+        Record record;
+        record.kind = static_cast<Kind>(data[pos++]);
+
+        uint64_t delta, requestLength, responseLength;
+        if (!readVarint(data, pos, delta) || !readVarint(data, pos, requestLength) ||
+            data.size() - pos < requestLength) break;
+        record.request = data.substr(pos, requestLength);
+        pos += requestLength;
+        if (!readVarint(data, pos, responseLength) || data.size() - pos < responseLength) break;
+        record.response = data.substr(pos, responseLength);
+        pos += responseLength;
+
+        time += delta;
+        record.timeUs = time;
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+} // namespace Capture
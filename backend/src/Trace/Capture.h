@@ -0,0 +1,64 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Recording of the server's traffic for later replay (see bench/Replay.cpp).
+ *
+ * Every text command and binary frame the server executes is appended to the
+ * capture file together with its response and the time it was answered, so a
+ * replay can reproduce the load's shape and check the new build's answers.
+ *
+ * File layout: the 8-byte magic "BLMCAP1\n", the capture start as u64 Unix
+ * microseconds (little-endian), then one record per request:
+ *
+ *   kind u8 | microseconds since the previous record, varint |
+ *   request length, varint | request | response length, varint | response
+ *
+ * Varints are LEB128. Text requests are the trimmed command line and text
+ * responses include the trailing newline; binary requests and responses are
+ * whole frames. Records are buffered and written in blocks, so a crash loses
+ * at most the last second or 64 KiB.
+ */
+namespace Capture {
+
+    enum Kind : uint8_t {
+        TEXT = 0,      // A text protocol command line
+        FRAME = 1      // A binary protocol frame
+    };
+
+    struct Record {
+        Kind kind;
+        uint64_t timeUs;       // Since the start of the capture
+        std::string request;
+        std::string response;
+    };
+
+    /**
+     * @brief Starts capturing to `path`, replacing the file.
+     * @return false if the file can't be created.
+     */
+    bool open(const std::string& path);
+
+    // True once open() has succeeded
+    bool enabled();
+
+    /**
+     * @brief Appends one request and its response.
+     */
+    void record(Kind kind, const char* request, size_t requestLength, const char* response, size_t responseLength);
+
+    // Writes out buffered records
+    void flush();
+
+    /**
+     * @brief Reads a whole capture file.
+     * @return false if the file is missing or not a capture; a truncated last record is dropped.
+     */
+    bool load(const std::string& path, std::vector<Record>& records);
+}
+
+#endif // CAPTURE_H
@@ -0,0 +1,206 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <pthread.h>                   // For pthread_sigmask()
+#include <time.h>                      // For clock_gettime()
+
+#if defined(__x86_64__)
+#include <x86intrin.h>                 // For __rdtsc()
+#endif
+
+namespace Trace {
+
+namespace {
+
+const size_t RING_SIZE = 4096;         // Spans kept per ring (power of two)
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {"recv", "parse", "lock_wait", "execute", "save", "send"};
+
+// One span. Fields are relaxed atomics so a concurrent dump is well-defined;
+// seq is 2 * index + 2 once the slot holds span `index`, odd while it's being written.
+struct Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+    std::atomic<const char*> op{nullptr};
+    std::atomic<uint32_t> bytes{0};
+    std::atomic<uint8_t> phase{0};
+};
+
+// Single-writer ring; owned by one thread at a time
+struct Ring {
+    explicit Ring(int lane) : lane(lane) {}
+
+    int lane;                          // Exported as the trace "tid"
+    uint64_t head = 0;                 // Next span index, only touched by the owner
+    Slot slots[RING_SIZE];
+};
+
+std::atomic<bool> tracing{true};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<Ring>> rings;  // Every ring ever created
+std::vector<Ring*> freeRings;              // Rings whose thread has exited
+
+// Returns the thread's ring to the pool when the thread exits
+struct RingHolder {
+    Ring* ring = nullptr;
+
+    ~RingHolder() {
+        if (!ring) return;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        freeRings.push_back(ring);
+    }
+};
+
+thread_local RingHolder holder;
+
+Ring* threadRing() {
+    if (holder.ring) return holder.ring;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (!freeRings.empty()) {
+        holder.ring = freeRings.back();
+        freeRings.pop_back();
+    } else {
+        rings.push_back(std::make_unique<Ring>(static_cast<int>(rings.size())));
+        holder.ring = rings.back().get();
+    }
+    return holder.ring;
+}
+
+uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+// Tick/nanosecond pair taken at startup, to convert TSC ticks on export
+struct Anchor {
+    uint64_t ticks;
+    uint64_t ns;
+};
+
+const Anchor START = {now(), monotonicNs()};
+
+// Ticks per nanosecond, measured against CLOCK_MONOTONIC since startup
+double ticksPerNs() {
+#if defined(__x86_64__)
+    // Give the measurement at least 10 ms to keep the error small
+    uint64_t ns = monotonicNs();
+    if (ns - START.ns < 10000000) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(10000000 - (ns - START.ns)));
+        ns = monotonicNs();
+    }
+    return double(now() - START.ticks) / double(ns - START.ns);
+#else
+    return 1.0;
+#endif
+}
+
+} // namespace
+
+uint64_t now() {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return monotonicNs();
+#endif
+}
+
+void record(Phase phase, const char* op, uint64_t start, uint64_t end, uint32_t bytes) {
+    if (!tracing.load(std::memory_order_relaxed)) return;
+
+    Ring* ring = threadRing();
+    uint64_t index = ring->head++;
+    Slot& slot = ring->slots[index & (RING_SIZE - 1)];
+
+    // Mark the slot as being written before touching the fields
+    slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.op.store(op, std::memory_order_relaxed);
+    slot.bytes.store(bytes, std::memory_order_relaxed);
+    slot.phase.store(phase, std::memory_order_relaxed);
+    slot.seq.store(2 * index + 2, std::memory_order_release);
+}
+
+void setEnabled(bool enabled) {
+    tracing.store(enabled, std::memory_order_relaxed);
+}
+
+bool enabled() {
+    return tracing.load(std::memory_order_relaxed);
+}
+
+std::string dumpChromeJson() {
+    double rate = ticksPerNs();
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char event[256];
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& ring : rings) {
+        for (const Slot& slot : ring->slots) {
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == 0 || (seq & 1)) continue;  // Empty or being written
+
+            uint64_t start = slot.start.load(std::memory_order_relaxed);
+            uint64_t end = slot.end.load(std::memory_order_relaxed);
+            const char* op = slot.op.load(std::memory_order_relaxed);
+            uint32_t bytes = slot.bytes.load(std::memory_order_relaxed);
+            uint8_t phase = slot.phase.load(std::memory_order_relaxed);
+
+            // The owner may have started overwriting the slot while we read it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+            if (phase >= PHASE_COUNT || end < start) continue;
+
+            // Chrome trace timestamps are microseconds
+            double ts = (double(start) - double(START.ticks)) / rate / 1000.0;
+            double dur = double(end - start) / rate / 1000.0;
+            std::snprintf(event, sizeof(event),
+                          "%s\n{\"name\":\"%s\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                          "\"pid\":1,\"tid\":%d,\"args\":{\"op\":\"%s\",\"bytes\":%u}}",
+                          first ? "" : ",", PHASE_NAMES[phase], ts, dur, ring->lane, op ? op : "", bytes);
+            out += event;
+            first = false;
+        }
+    }
+
+    out += "\n]}";
+    return out;
+}
+
+void dumpOnSignal(int signal, const std::string& path) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, signal);
+    pthread_sigmask(SIG_BLOCK, &set, nullptr);
+
+    std::thread([set, path]() {
+        while (true) {
+            int received;
+            if (sigwait(&set, &received) != 0) continue;
+
+            // Write next to the target and rename, so readers never see a partial file
+            std::string tmp = path + ".tmp";
+            {
+                std::ofstream out(tmp);
+                out << dumpChromeJson() << "\n";
+            }
+            std::rename(tmp.c_str(), path.c_str());
+        }
+    }).detach();
+}
+
+} // namespace Trace
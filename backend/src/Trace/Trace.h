@@ -0,0 +1,91 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Always-on request tracing into per-thread ring buffers.
+ *
+ * Each instrumented phase of a request (recv, parse, waiting for the filter
+ * lock, execute, save, send) records one fixed-size span: start and end
+ * timestamps, an operation label and a byte count. Spans go into a ring owned
+ * by the recording thread, so recording takes no lock and never blocks; old
+ * spans are overwritten. Rings outlive their threads and are handed to new
+ * threads, since the server starts one thread per connection.
+ *
+ * dumpChromeJson() copies the recent window out of every ring (each slot is
+ * guarded by a sequence number, so spans being overwritten are skipped) and
+ * formats it as Chrome trace JSON for chrome://tracing or Perfetto.
+ */
+namespace Trace {
+
+    // Request phases; the names appear in the exported trace
+    enum Phase : uint8_t {
+        RECV,        // Reading request bytes from the socket
+        PARSE,       // Parsing a text command and creating it
+        LOCK_WAIT,   // Waiting for the filter mutex
+        EXECUTE,     // Running the command on the filter
+        SAVE,        // Writing the filter state to disk
+        SEND,        // Writing the response to the socket
+        PHASE_COUNT
+    };
+
+    /**
+     * @brief Current timestamp in trace ticks: the TSC on x86-64, otherwise
+     *        CLOCK_MONOTONIC nanoseconds. Converted to time on export.
+     */
+    uint64_t now();
+
+    /**
+     * @brief Records one span in the calling thread's ring.
+     *
+     * @param phase The request phase the span covers.
+     * @param op Operation label; must be a string literal (only the pointer is stored).
+     * @param start Timestamp from now() at the start of the phase.
+     * @param end Timestamp from now() at the end of the phase.
+     * @param bytes Bytes moved or processed in the phase, if meaningful.
+     */
+    void record(Phase phase, const char* op, uint64_t start, uint64_t end, uint32_t bytes = 0);
+
+    // Turns recording on or off (on by default)
+    void setEnabled(bool enabled);
+    bool enabled();
+
+    /**
+     * @brief Exports the spans currently held in every ring as Chrome trace JSON.
+     */
+    std::string dumpChromeJson();
+
+    /**
+     * @brief Writes dumpChromeJson() to `path` whenever the process receives `signal`.
+     *
+     * Blocks the signal in the calling thread, which threads created later
+     * inherit, and waits for it on a dedicated thread, so the dump never runs
+     * in a signal handler. Call before starting other threads.
+     */
+    void dumpOnSignal(int signal, const std::string& path);
+
+    /**
+     * @brief Records a span covering the scope's lifetime.
+     */
+    class Scope {
+    public:
+        Scope(Phase phase, const char* op, uint32_t bytes = 0)
+            : phase(phase), op(op), bytes(bytes), start(now()) {}
+        ~Scope() { record(phase, op, start, now(), bytes); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        void setBytes(uint32_t value) { bytes = value; }
+
+    private:
+        Phase phase;
+        const char* op;
+        uint32_t bytes;
+        uint64_t start;
+    };
+}
+
+#endif // TRACE_H
@@ -1,7 +1,16 @@
 
 #include "Server/Server.h"             // Server class definition
+#include "Server/ServerOptions.h"      // Optional "--name=value" settings
 #include "Bloom/InputValidator.h"      // Input validation utilities
-#include "Bloom/BloomFilter.h"
+#include "Bloom/Namespaces.h"          // Named filters sharing one arena
+#include "Trace/Trace.h"              // Request tracing, dumped on SIGUSR1
+#include "Analytics/HotKeys.h"        // Heavy-hitter counts for TOPK
+#include "Trace/Capture.h"            // Traffic recording for the replay tool
+#include "Server/Handoff.h"           // Taking over from a running server
+#include <csignal>
+#include <cstdlib>                    // For std::_Exit
+#include <iostream>
+#include <pthread.h>                  // For pthread_sigmask()
 #include <string>
 #include <vector>
 #include <algorithm>                  // For std::all_of
@@ -11,19 +20,27 @@
 /**
  * Entry point of the server application.
  * Expects command-line arguments in the format:
- * ./server <PORT> <FILTER_SIZE> <HASH_DEPTH_1> <HASH_DEPTH_2> ...
+ * ./server [--option=value ...] <PORT> <FILTER_SIZE> <HASH_DEPTH_1> <HASH_DEPTH_2> ...
  */
 int main(int argc, char* argv[]) {
-    // Check if there are at least 3 arguments (program name + 2 others)
-    if (argc < 3) return 1;
+    ServerOptions options;
+    std::vector<std::string> args;        // Positional arguments, options removed
 
-    // Reject any argument containing whitespace (invalid input)
+    // Reject any argument containing whitespace (invalid input), and split off options
     for (int i = 1; i < argc; ++i) {
         std::string arg(argv[i]);
         if (containsAnyWhitespace(arg)) return 1;
+        if (arg.compare(0, 2, "--") == 0) {
+            if (!parseServerOption(arg, options)) return 1;
+        } else {
+            args.push_back(arg);
+        }
     }
 
-    std::string portStr = argv[1];        // Port string from user input
+    // Check if there are at least 2 positional arguments (port + filter size)
+    if (args.size() < 2) return 1;
+
+    std::string portStr = args[0];        // Port string from user input
 
     // Validate port string is a number
     if (portStr.empty() || !std::all_of(portStr.begin(), portStr.end(), ::isdigit)) return 1;
@@ -35,9 +52,9 @@ int main(int argc, char* argv[]) {
 
     // Reconstruct configuration line (space-separated values after port)
     std::string configLine;
-    for (int i = 2; i < argc; ++i) {
-        configLine += argv[i];
-        if (i != argc - 1) configLine += " ";
+    for (size_t i = 1; i < args.size(); ++i) {
+        configLine += args[i];
+        if (i != args.size() - 1) configLine += " ";
     }
 
     size_t filterSize;
@@ -46,14 +63,49 @@ int main(int argc, char* argv[]) {
     // Validate the config line and extract filter size and hash function depths
     if (!parseInitialConfig(configLine, filterSize, hashFuncs)) return 1;
 
+    // SIGTERM starts a graceful shutdown, handled by the server on its own thread.
+    // Block it before any thread starts so they all inherit the blocked signal.
+    sigset_t terminate;
+    sigemptyset(&terminate);
+    sigaddset(&terminate, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &terminate, nullptr);
+
+    // Tracing is on unless disabled; SIGUSR1 writes the recent spans to a file.
+    // Set up before any thread starts so they all inherit the blocked signal.
+    Trace::setEnabled(options.trace);
+    Trace::dumpOnSignal(SIGUSR1, "data/trace.json");
+    HotKeys::instance().setEnabled(options.hotKeys);
+    if (!options.capturePath.empty() && !Capture::open(options.capturePath)) return 1;
+
+    // With a handoff socket, take over the listeners of a server already running there.
+    // This waits until it has drained and written its final snapshots, which the filters then load.
+    std::vector<int> inherited;
+    if (!options.handoffPath.empty() && Handoff::takeOver(options.handoffPath, inherited)) {
+        std::cout << "Taking over from the previous server" << std::endl;
+    }
+
     try {
         // Create and start the server with port and config (IP removed)
-        BloomFilter* sharedBloom = new BloomFilter(filterSize, hashFuncs, "data/filter_data.txt");
+        ExpiryConfig expiry;
+        expiry.defaultTtl = options.defaultTtl;
+        expiry.generationSeconds = options.generationSeconds;
+        expiry.generations = options.ttlGenerations;
+        MemoryConfig memory;
+        memory.hugePages = options.hugePages;
+        memory.numaReplicate = options.numaReplicate;
+        Namespaces* namespaces = new Namespaces(filterSize, hashFuncs, "data", expiry, memory,
+                                                options.verdictCache, options.fpMemo,
+                                                options.maxNamespaceBits, options.maxHashDepth);
         ThreadManager threadManager;
-        Server server(port, configLine, sharedBloom, &threadManager);
-
+        Server server(port, configLine, namespaces, &threadManager, options);
+        server.inheritListeners(inherited);
 
         server.run();
+
+        // Connections still open after the drain timeout may be running:
+        // exit without destroying anything they could be using
+        std::cout.flush();
+        std::_Exit(0);
     } catch (...) {
         return 1;
     }